@@ -0,0 +1,1059 @@
+/*
+ * 압축 커버리지 저장소 (coverage store)
+ *
+ * 실행(run)마다 히트된 엣지 집합을 Roaring 방식의 압축 비트맵으로 디스크에 저장하고,
+ * run id 와 메타데이터(프로그램, 모드, 타임스탬프)로 색인합니다.
+ * nedges 바이트짜리 kc_hits 배열을 그대로 저장하는 대신, 엣지 인덱스를 상위 16비트 키로
+ * 나눈 컨테이너 단위로 저장합니다.
+ *   - ARRAY 컨테이너 : 히트 수가 4096 이하이면 정렬된 uint16_t 배열
+ *   - BITMAP 컨테이너: 그 외에는 65536 비트(8KB) 비트맵
+ *
+ * 저장소 디렉토리 구성:
+ *   runs.idx  - 헤더 + 고정 크기 run 레코드 (메타데이터, runs.dat 내 오프셋)
+ *   runs.dat  - 직렬화된 비트맵들을 이어붙인 파일 (append-only)
+ *
+ * 질의(union / intersect / who-hit / unique)는 runs.dat 를 mmap 하여 복사 없이 수행하며,
+ * 비트맵 컨테이너 연산은 NEON(arm64) / SSE2(x86_64) 로 처리합니다.
+ *
+ * 컴파일: gcc -O2 -o coverage_store coverage_store.c
+ * 실행:
+ *   sudo ./coverage_store record [--exec 프로그램 [인자...]]
+ *   ./coverage_store import hits.bin --program 이름 [--mode trace]
+ *   ./coverage_store list
+ *   ./coverage_store union [--program 이름] [--mode 모드] [--since ts] [--until ts]
+ *   ./coverage_store intersect [필터...]
+ *   ./coverage_store who-hit <edge>
+ *   ./coverage_store unique <run_id>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* ksancov 헤더 파일에서 필요한 정의들 */
+#define KSANCOV_PATH "/dev/ksancov"
+
+/* ioctl 명령어들 */
+#define KSANCOV_IOC_COUNTERS     _IO('K', 2)
+#define KSANCOV_IOC_MAP          _IOWR('K', 8, struct ksancov_buf_desc)
+#define KSANCOV_IOC_START        _IOW('K', 10, uintptr_t)
+
+/* 매직 넘버들 */
+#define KSANCOV_COUNTERS_MAGIC  (uint32_t)0x5AD27F6BU
+
+/* 버퍼 설명자 */
+struct ksancov_buf_desc {
+    uintptr_t ptr;
+    size_t sz;
+};
+
+/* 공통 헤더 */
+typedef struct ksancov_header {
+    uint32_t         kh_magic;
+    _Atomic uint32_t kh_enabled;
+} ksancov_header_t;
+
+/* COUNTERS 모드 구조체 */
+typedef struct ksancov_counters {
+    ksancov_header_t kc_hdr;
+    uint32_t         kc_nedges;
+    uint8_t          kc_hits[];
+} ksancov_counters_t;
+
+/* 저장소 포맷 정의 */
+#define COVSTORE_IDX_MAGIC      (uint32_t)0x43535449U   /* "ITSC" */
+#define COVSTORE_BLOB_MAGIC     (uint32_t)0x43535442U   /* "BTSC" */
+#define COVSTORE_VERSION        1
+
+#define COVSTORE_CHUNK_BITS     65536
+#define COVSTORE_CHUNK_WORDS    (COVSTORE_CHUNK_BITS / 64)
+#define COVSTORE_ARRAY_MAX      4096
+
+#define COVSTORE_PROGRAM_LEN    64
+
+/* 수집 모드 */
+typedef enum {
+    COVSTORE_MODE_COUNTERS = 1,
+    COVSTORE_MODE_TRACE    = 2,
+} covstore_mode_t;
+
+/* 컨테이너 타입 */
+typedef enum {
+    COVSTORE_CONTAINER_ARRAY  = 1,
+    COVSTORE_CONTAINER_BITMAP = 2,
+} covstore_container_type_t;
+
+/* runs.idx 헤더 */
+typedef struct covstore_idx_header {
+    uint32_t ci_magic;
+    uint32_t ci_version;
+    uint32_t ci_nruns;
+    uint32_t ci_nedges;
+} covstore_idx_header_t;
+
+/* runs.idx 레코드 (run 하나당 하나) */
+typedef struct covstore_run {
+    uint32_t cr_run_id;
+    uint32_t cr_mode;
+    uint64_t cr_timestamp;
+    uint64_t cr_offset;         /* runs.dat 내 비트맵 시작 오프셋 */
+    uint32_t cr_length;         /* 직렬화된 비트맵 크기 (바이트) */
+    uint32_t cr_cardinality;    /* 히트된 엣지 수 */
+    char     cr_program[COVSTORE_PROGRAM_LEN];
+} covstore_run_t;
+
+/* 직렬화된 비트맵 헤더 */
+typedef struct covstore_blob {
+    uint32_t cb_magic;
+    uint32_t cb_ncontainers;
+} covstore_blob_t;
+
+/* 컨테이너 디렉토리 엔트리 (key 오름차순) */
+typedef struct covstore_container {
+    uint16_t cc_key;            /* 엣지 인덱스 상위 16비트 */
+    uint16_t cc_type;
+    uint32_t cc_card;
+    uint64_t cc_offset;         /* 블롭 시작 기준 페이로드 오프셋 */
+} covstore_container_t;
+
+/* 열린 저장소 */
+typedef struct covstore {
+    int                    idx_fd;
+    int                    dat_fd;
+    covstore_idx_header_t *hdr;
+    covstore_run_t        *runs;
+    uint32_t               nruns;       /* 연 시점의 run 수 (질의는 이 값만 사용) */
+    size_t                 idx_size;
+    const uint8_t         *dat;
+    size_t                 dat_size;
+} covstore_t;
+
+/* run 선택 필터 */
+typedef struct covstore_filter {
+    const char *program;
+    uint32_t    mode;
+    uint64_t    since;
+    uint64_t    until;
+} covstore_filter_t;
+
+/* 헬퍼 함수들 */
+static int ksancov_open(void) {
+    return open(KSANCOV_PATH, O_RDWR);
+}
+
+static int ksancov_map(int fd, uintptr_t *buf, size_t *sz) {
+    struct ksancov_buf_desc mc = {0};
+    int ret = ioctl(fd, KSANCOV_IOC_MAP, &mc);
+    if (ret == -1) {
+        return errno;
+    }
+    *buf = mc.ptr;
+    if (sz) {
+        *sz = mc.sz;
+    }
+    return 0;
+}
+
+static int ksancov_mode_counters(int fd) {
+    int ret = ioctl(fd, KSANCOV_IOC_COUNTERS);
+    return (ret == -1) ? errno : 0;
+}
+
+static int ksancov_thread_self(int fd) {
+    uintptr_t th = 0;
+    int ret = ioctl(fd, KSANCOV_IOC_START, &th);
+    return (ret == -1) ? errno : 0;
+}
+
+static void ksancov_start(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 1, memory_order_relaxed);
+}
+
+static void ksancov_stop(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 0, memory_order_relaxed);
+}
+
+/* ---- 비트 연산 (SIMD) ---- */
+
+/* 8바이트의 각 바이트가 0이 아닌지를 8비트 마스크로 변환 */
+static inline uint32_t nonzero_mask8(uint64_t x) {
+    uint64_t t = (((x & 0x7f7f7f7f7f7f7f7fULL) + 0x7f7f7f7f7f7f7f7fULL) | x) & 0x8080808080808080ULL;
+    return (uint32_t)(((t >> 7) * 0x0102040810204080ULL) >> 56);
+}
+
+/* kc_hits 배열을 밀집 비트맵으로 변환 (hits[i] != 0 이면 비트 i 설정) */
+static void hits_to_bits(const uint8_t *hits, size_t n, uint64_t *bits) {
+    size_t nwords = (n + 63) / 64;
+    memset(bits, 0, nwords * sizeof(uint64_t));
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(hits + i));
+        uint32_t m = (uint32_t)~_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) & 0xffffU;
+        bits[i / 64] |= (uint64_t)m << (i % 64);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t w = vld1q_u8(weights);
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t v = vandq_u8(vtstq_u8(vld1q_u8(hits + i), vld1q_u8(hits + i)), w);
+        uint32_t m = (uint32_t)vaddv_u8(vget_low_u8(v)) | ((uint32_t)vaddv_u8(vget_high_u8(v)) << 8);
+        bits[i / 64] |= (uint64_t)m << (i % 64);
+    }
+#endif
+    for (; i + 8 <= n; i += 8) {
+        uint64_t x;
+        memcpy(&x, hits + i, sizeof(x));
+        bits[i / 64] |= (uint64_t)nonzero_mask8(x) << (i % 64);
+    }
+    for (; i < n; i++) {
+        if (hits[i]) {
+            bits[i / 64] |= 1ULL << (i % 64);
+        }
+    }
+}
+
+static void words_or(uint64_t *dst, const uint64_t *src, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 2 <= n; i += 2) {
+        vst1q_u64(dst + i, vorrq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(a, b));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] |= src[i];
+    }
+}
+
+static void words_and(uint64_t *dst, const uint64_t *src, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 2 <= n; i += 2) {
+        vst1q_u64(dst + i, vandq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_and_si128(a, b));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] &= src[i];
+    }
+}
+
+/* dst = dst & ~src */
+static void words_andnot(uint64_t *dst, const uint64_t *src, size_t n) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 2 <= n; i += 2) {
+        vst1q_u64(dst + i, vbicq_u64(vld1q_u64(dst + i), vld1q_u64(src + i)));
+    }
+#elif defined(__SSE2__)
+    for (; i + 2 <= n; i += 2) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_andnot_si128(b, a));
+    }
+#endif
+    for (; i < n; i++) {
+        dst[i] &= ~src[i];
+    }
+}
+
+static uint64_t words_popcount(const uint64_t *src, size_t n) {
+    uint64_t total = 0;
+    size_t i = 0;
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 2 <= n; i += 2) {
+        total += vaddvq_u8(vcntq_u8(vreinterpretq_u8_u64(vld1q_u64(src + i))));
+    }
+#endif
+    for (; i < n; i++) {
+        total += (uint64_t)__builtin_popcountll(src[i]);
+    }
+    return total;
+}
+
+/* ---- 비트맵 직렬화 ---- */
+
+static size_t align8(size_t v) {
+    return (v + 7) & ~(size_t)7;
+}
+
+/*
+ * 밀집 비트맵(nedges 비트)을 Roaring 블롭으로 직렬화합니다.
+ * 반환된 버퍼는 호출자가 free 해야 합니다.
+ */
+static uint8_t *bits_to_blob(const uint64_t *bits, size_t nedges, size_t *out_len, uint32_t *out_card) {
+    size_t nchunks = (nedges + COVSTORE_CHUNK_BITS - 1) / COVSTORE_CHUNK_BITS;
+    size_t nwords = (nedges + 63) / 64;
+
+    /* 1차: 컨테이너 수와 크기 계산 */
+    uint32_t ncontainers = 0;
+    size_t payload = 0;
+    uint32_t total = 0;
+    for (size_t c = 0; c < nchunks; c++) {
+        size_t w0 = c * COVSTORE_CHUNK_WORDS;
+        size_t nw = nwords - w0 < COVSTORE_CHUNK_WORDS ? nwords - w0 : COVSTORE_CHUNK_WORDS;
+        uint64_t card = words_popcount(bits + w0, nw);
+        if (card == 0) {
+            continue;
+        }
+        ncontainers++;
+        total += (uint32_t)card;
+        payload += card <= COVSTORE_ARRAY_MAX ? align8(card * sizeof(uint16_t))
+                                              : COVSTORE_CHUNK_WORDS * sizeof(uint64_t);
+    }
+
+    size_t hdr_len = sizeof(covstore_blob_t) + ncontainers * sizeof(covstore_container_t);
+    size_t len = align8(hdr_len) + payload;
+    uint8_t *blob = calloc(1, len);
+    if (!blob) {
+        return NULL;
+    }
+
+    covstore_blob_t *bh = (covstore_blob_t *)blob;
+    covstore_container_t *dir = (covstore_container_t *)(blob + sizeof(covstore_blob_t));
+    bh->cb_magic = COVSTORE_BLOB_MAGIC;
+    bh->cb_ncontainers = ncontainers;
+
+    /* 2차: 컨테이너 채우기 */
+    size_t off = align8(hdr_len);
+    uint32_t k = 0;
+    for (size_t c = 0; c < nchunks; c++) {
+        size_t w0 = c * COVSTORE_CHUNK_WORDS;
+        size_t nw = nwords - w0 < COVSTORE_CHUNK_WORDS ? nwords - w0 : COVSTORE_CHUNK_WORDS;
+        uint64_t card = words_popcount(bits + w0, nw);
+        if (card == 0) {
+            continue;
+        }
+        dir[k].cc_key = (uint16_t)c;
+        dir[k].cc_card = (uint32_t)card;
+        dir[k].cc_offset = off;
+        if (card <= COVSTORE_ARRAY_MAX) {
+            dir[k].cc_type = COVSTORE_CONTAINER_ARRAY;
+            uint16_t *arr = (uint16_t *)(blob + off);
+            size_t n = 0;
+            for (size_t w = 0; w < nw; w++) {
+                uint64_t word = bits[w0 + w];
+                while (word) {
+                    arr[n++] = (uint16_t)(w * 64 + (size_t)__builtin_ctzll(word));
+                    word &= word - 1;
+                }
+            }
+            off += align8(card * sizeof(uint16_t));
+        } else {
+            dir[k].cc_type = COVSTORE_CONTAINER_BITMAP;
+            memcpy(blob + off, bits + w0, nw * sizeof(uint64_t));
+            off += COVSTORE_CHUNK_WORDS * sizeof(uint64_t);
+        }
+        k++;
+    }
+
+    *out_len = len;
+    *out_card = total;
+    return blob;
+}
+
+static const covstore_container_t *blob_find(const uint8_t *blob, uint16_t key) {
+    const covstore_blob_t *bh = (const covstore_blob_t *)blob;
+    const covstore_container_t *dir = (const covstore_container_t *)(blob + sizeof(covstore_blob_t));
+    size_t lo = 0, hi = bh->cb_ncontainers;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (dir[mid].cc_key < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return (lo < bh->cb_ncontainers && dir[lo].cc_key == key) ? &dir[lo] : NULL;
+}
+
+static int blob_contains(const uint8_t *blob, uint32_t edge) {
+    const covstore_container_t *c = blob_find(blob, (uint16_t)(edge >> 16));
+    if (!c) {
+        return 0;
+    }
+    uint16_t low = (uint16_t)(edge & 0xffff);
+    if (c->cc_type == COVSTORE_CONTAINER_BITMAP) {
+        const uint64_t *bm = (const uint64_t *)(blob + c->cc_offset);
+        return (bm[low / 64] >> (low % 64)) & 1;
+    }
+    const uint16_t *arr = (const uint16_t *)(blob + c->cc_offset);
+    size_t lo = 0, hi = c->cc_card;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (arr[mid] < low) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo < c->cc_card && arr[lo] == low;
+}
+
+/* 컨테이너를 8KB 비트맵으로 펼침 */
+static const uint64_t *container_words(const uint8_t *blob, const covstore_container_t *c, uint64_t *tmp) {
+    if (c->cc_type == COVSTORE_CONTAINER_BITMAP) {
+        return (const uint64_t *)(blob + c->cc_offset);
+    }
+    const uint16_t *arr = (const uint16_t *)(blob + c->cc_offset);
+    memset(tmp, 0, COVSTORE_CHUNK_WORDS * sizeof(uint64_t));
+    for (uint32_t i = 0; i < c->cc_card; i++) {
+        tmp[arr[i] / 64] |= 1ULL << (arr[i] % 64);
+    }
+    return tmp;
+}
+
+/* acc |= blob */
+static void acc_or_blob(uint64_t *acc, size_t nwords, const uint8_t *blob) {
+    const covstore_blob_t *bh = (const covstore_blob_t *)blob;
+    const covstore_container_t *dir = (const covstore_container_t *)(blob + sizeof(covstore_blob_t));
+    for (uint32_t k = 0; k < bh->cb_ncontainers; k++) {
+        const covstore_container_t *c = &dir[k];
+        size_t w0 = (size_t)c->cc_key * COVSTORE_CHUNK_WORDS;
+        if (w0 >= nwords) {
+            continue;
+        }
+        if (c->cc_type == COVSTORE_CONTAINER_BITMAP) {
+            size_t nw = nwords - w0 < COVSTORE_CHUNK_WORDS ? nwords - w0 : COVSTORE_CHUNK_WORDS;
+            words_or(acc + w0, (const uint64_t *)(blob + c->cc_offset), nw);
+        } else {
+            /* ARRAY 컨테이너는 펼치지 않고 바로 비트를 세팅 */
+            const uint16_t *arr = (const uint16_t *)(blob + c->cc_offset);
+            uint64_t *chunk = acc + w0;
+            for (uint32_t i = 0; i < c->cc_card; i++) {
+                chunk[arr[i] / 64] |= 1ULL << (arr[i] % 64);
+            }
+        }
+    }
+}
+
+/* acc &= blob */
+static void acc_and_blob(uint64_t *acc, size_t nwords, const uint8_t *blob, uint64_t *tmp) {
+    size_t nchunks = (nwords + COVSTORE_CHUNK_WORDS - 1) / COVSTORE_CHUNK_WORDS;
+    for (size_t key = 0; key < nchunks; key++) {
+        size_t w0 = key * COVSTORE_CHUNK_WORDS;
+        size_t nw = nwords - w0 < COVSTORE_CHUNK_WORDS ? nwords - w0 : COVSTORE_CHUNK_WORDS;
+        const covstore_container_t *c = blob_find(blob, (uint16_t)key);
+        if (!c) {
+            memset(acc + w0, 0, nw * sizeof(uint64_t));
+            continue;
+        }
+        words_and(acc + w0, container_words(blob, c, tmp), nw);
+    }
+}
+
+/* ---- 저장소 파일 관리 ---- */
+
+static int covstore_path(char *out, size_t outlen, const char *dir, const char *name) {
+    int n = snprintf(out, outlen, "%s/%s", dir, name);
+    return (n < 0 || (size_t)n >= outlen) ? ENAMETOOLONG : 0;
+}
+
+static void covstore_close(covstore_t *cs) {
+    if (cs->runs) {
+        munmap(cs->hdr, cs->idx_size);
+    }
+    if (cs->dat && cs->dat_size) {
+        munmap((void *)cs->dat, cs->dat_size);
+    }
+    if (cs->idx_fd >= 0) {
+        close(cs->idx_fd);
+    }
+    if (cs->dat_fd >= 0) {
+        close(cs->dat_fd);
+    }
+    memset(cs, 0, sizeof(*cs));
+    cs->idx_fd = cs->dat_fd = -1;
+}
+
+/* 질의용으로 저장소를 읽기 전용 mmap 합니다. */
+static int covstore_open(covstore_t *cs, const char *dir) {
+    char path[1024];
+    struct stat st;
+    int ret;
+
+    memset(cs, 0, sizeof(*cs));
+    cs->idx_fd = cs->dat_fd = -1;
+
+    if ((ret = covstore_path(path, sizeof(path), dir, "runs.idx")) != 0) {
+        return ret;
+    }
+    cs->idx_fd = open(path, O_RDONLY);
+    if (cs->idx_fd < 0 || fstat(cs->idx_fd, &st) != 0) {
+        ret = errno;
+        covstore_close(cs);
+        return ret;
+    }
+    if ((size_t)st.st_size < sizeof(covstore_idx_header_t)) {
+        covstore_close(cs);
+        return EINVAL;
+    }
+    cs->idx_size = (size_t)st.st_size;
+    void *p = mmap(NULL, cs->idx_size, PROT_READ, MAP_SHARED, cs->idx_fd, 0);
+    if (p == MAP_FAILED) {
+        ret = errno;
+        covstore_close(cs);
+        return ret;
+    }
+    cs->hdr = p;
+    cs->runs = (covstore_run_t *)((uint8_t *)p + sizeof(covstore_idx_header_t));
+    if (cs->hdr->ci_magic != COVSTORE_IDX_MAGIC || cs->hdr->ci_version != COVSTORE_VERSION) {
+        covstore_close(cs);
+        return EINVAL;
+    }
+    /*
+     * ci_nruns 는 MAP_SHARED 로 보이므로 질의 중에 record/import 가 추가하면 커질 수 있습니다.
+     * 한 번만 읽어 매핑된 크기 안의 레코드 수로 제한한 스냅샷을 사용합니다.
+     */
+    uint32_t nruns = atomic_load_explicit((_Atomic uint32_t *)&cs->hdr->ci_nruns, memory_order_acquire);
+    size_t mapped = (cs->idx_size - sizeof(covstore_idx_header_t)) / sizeof(covstore_run_t);
+    cs->nruns = (size_t)nruns < mapped ? nruns : (uint32_t)mapped;
+
+    if ((ret = covstore_path(path, sizeof(path), dir, "runs.dat")) != 0) {
+        covstore_close(cs);
+        return ret;
+    }
+    cs->dat_fd = open(path, O_RDONLY);
+    if (cs->dat_fd < 0 || fstat(cs->dat_fd, &st) != 0) {
+        ret = errno;
+        covstore_close(cs);
+        return ret;
+    }
+    cs->dat_size = (size_t)st.st_size;
+    if (cs->dat_size > 0) {
+        p = mmap(NULL, cs->dat_size, PROT_READ, MAP_SHARED, cs->dat_fd, 0);
+        if (p == MAP_FAILED) {
+            ret = errno;
+            cs->dat_size = 0;
+            covstore_close(cs);
+            return ret;
+        }
+        cs->dat = p;
+    }
+    return 0;
+}
+
+static const uint8_t *covstore_blob(const covstore_t *cs, const covstore_run_t *run) {
+    if (run->cr_offset + run->cr_length > cs->dat_size) {
+        return NULL;
+    }
+    const uint8_t *blob = cs->dat + run->cr_offset;
+    return ((const covstore_blob_t *)blob)->cb_magic == COVSTORE_BLOB_MAGIC ? blob : NULL;
+}
+
+/*
+ * 히트 배열 하나를 새 run 으로 추가합니다.
+ * runs.dat 에 비트맵을 먼저 기록한 뒤 runs.idx 에 레코드를 추가하므로,
+ * 도중에 중단되더라도 색인에는 완전히 기록된 run 만 나타납니다.
+ */
+static int covstore_append(const char *dir, const uint8_t *hits, size_t nedges,
+                           uint32_t mode, const char *program, uint32_t *out_run_id) {
+    char path[1024];
+    int ret = 0;
+    int idx_fd = -1, dat_fd = -1;
+    uint64_t *bits = NULL;
+    uint8_t *blob = NULL;
+
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        return errno;
+    }
+
+    if ((ret = covstore_path(path, sizeof(path), dir, "runs.idx")) != 0) {
+        return ret;
+    }
+    idx_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (idx_fd < 0) {
+        return errno;
+    }
+    if (flock(idx_fd, LOCK_EX) != 0) {
+        ret = errno;
+        goto out;
+    }
+
+    covstore_idx_header_t hdr;
+    ssize_t n = pread(idx_fd, &hdr, sizeof(hdr), 0);
+    if (n == 0) {
+        hdr.ci_magic = COVSTORE_IDX_MAGIC;
+        hdr.ci_version = COVSTORE_VERSION;
+        hdr.ci_nruns = 0;
+        hdr.ci_nedges = (uint32_t)nedges;
+    } else if (n != (ssize_t)sizeof(hdr) || hdr.ci_magic != COVSTORE_IDX_MAGIC ||
+               hdr.ci_version != COVSTORE_VERSION) {
+        ret = EINVAL;
+        goto out;
+    } else if (hdr.ci_nedges != nedges) {
+        /* 다른 커널(엣지 수가 다른)의 run 은 같은 저장소에 섞지 않음 */
+        ret = ERANGE;
+        goto out;
+    }
+
+    bits = malloc(((nedges + 63) / 64) * sizeof(uint64_t) + sizeof(uint64_t));
+    if (!bits) {
+        ret = ENOMEM;
+        goto out;
+    }
+    hits_to_bits(hits, nedges, bits);
+
+    size_t blob_len;
+    uint32_t card;
+    blob = bits_to_blob(bits, nedges, &blob_len, &card);
+    if (!blob) {
+        ret = ENOMEM;
+        goto out;
+    }
+
+    if ((ret = covstore_path(path, sizeof(path), dir, "runs.dat")) != 0) {
+        goto out;
+    }
+    dat_fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    if (dat_fd < 0 || fstat(dat_fd, &st) != 0) {
+        ret = errno;
+        goto out;
+    }
+    uint64_t offset = align8((size_t)st.st_size);
+    /* 짧은 쓰기는 errno 를 바꾸지 않으므로 (mkdir 의 EEXIST 등이 남지 않게) 매번 비움 */
+    errno = 0;
+    if (pwrite(dat_fd, blob, blob_len, (off_t)offset) != (ssize_t)blob_len || fsync(dat_fd) != 0) {
+        ret = errno ? errno : EIO;
+        goto out;
+    }
+
+    covstore_run_t run = {0};
+    run.cr_run_id = hdr.ci_nruns;
+    run.cr_mode = mode;
+    run.cr_timestamp = (uint64_t)time(NULL);
+    run.cr_offset = offset;
+    run.cr_length = (uint32_t)blob_len;
+    run.cr_cardinality = card;
+    strncpy(run.cr_program, program ? program : "", sizeof(run.cr_program) - 1);
+
+    off_t rec_off = (off_t)(sizeof(hdr) + (size_t)hdr.ci_nruns * sizeof(run));
+    errno = 0;
+    if (pwrite(idx_fd, &run, sizeof(run), rec_off) != (ssize_t)sizeof(run)) {
+        ret = errno ? errno : EIO;
+        goto out;
+    }
+    hdr.ci_nruns++;
+    errno = 0;
+    if (pwrite(idx_fd, &hdr, sizeof(hdr), 0) != (ssize_t)sizeof(hdr) || fsync(idx_fd) != 0) {
+        ret = errno ? errno : EIO;
+        goto out;
+    }
+
+    printf("run %u 저장 완료: 히트 엣지 %u / %zu, 압축 크기 %zu 바이트 (원본 %zu 바이트)\n",
+           run.cr_run_id, card, nedges, blob_len, nedges);
+    if (out_run_id) {
+        *out_run_id = run.cr_run_id;
+    }
+
+out:
+    free(blob);
+    free(bits);
+    if (dat_fd >= 0) {
+        close(dat_fd);
+    }
+    flock(idx_fd, LOCK_UN);
+    close(idx_fd);
+    return ret;
+}
+
+/* ---- 질의 ---- */
+
+static int filter_match(const covstore_filter_t *f, const covstore_run_t *run) {
+    if (f->program && strncmp(run->cr_program, f->program, sizeof(run->cr_program)) != 0) {
+        return 0;
+    }
+    if (f->mode && run->cr_mode != f->mode) {
+        return 0;
+    }
+    if (f->since && run->cr_timestamp < f->since) {
+        return 0;
+    }
+    if (f->until && run->cr_timestamp > f->until) {
+        return 0;
+    }
+    return 1;
+}
+
+static const char *mode_name(uint32_t mode) {
+    switch (mode) {
+    case COVSTORE_MODE_COUNTERS: return "counters";
+    case COVSTORE_MODE_TRACE:    return "trace";
+    default:                     return "?";
+    }
+}
+
+static uint32_t mode_from_name(const char *name) {
+    if (strcmp(name, "counters") == 0) {
+        return COVSTORE_MODE_COUNTERS;
+    }
+    if (strcmp(name, "trace") == 0) {
+        return COVSTORE_MODE_TRACE;
+    }
+    return 0;
+}
+
+static void print_edges(const uint64_t *bits, size_t nwords, size_t limit) {
+    size_t shown = 0;
+    for (size_t w = 0; w < nwords && shown < limit; w++) {
+        uint64_t word = bits[w];
+        while (word && shown < limit) {
+            printf("  엣지 %zu\n", w * 64 + (size_t)__builtin_ctzll(word));
+            word &= word - 1;
+            shown++;
+        }
+    }
+}
+
+static int cmd_list(const covstore_t *cs) {
+    printf("총 run 수: %u, 엣지 수: %u\n", cs->nruns, cs->hdr->ci_nedges);
+    for (uint32_t i = 0; i < cs->nruns; i++) {
+        const covstore_run_t *r = &cs->runs[i];
+        printf("  run %u: program=%.*s mode=%s ts=%llu 히트=%u 크기=%u\n",
+               r->cr_run_id, COVSTORE_PROGRAM_LEN, r->cr_program, mode_name(r->cr_mode),
+               (unsigned long long)r->cr_timestamp, r->cr_cardinality, r->cr_length);
+    }
+    return 0;
+}
+
+/* 필터에 맞는 run 들의 합집합(is_union) 또는 교집합을 계산 */
+static int cmd_setop(const covstore_t *cs, const covstore_filter_t *f, int is_union) {
+    size_t nwords = ((size_t)cs->hdr->ci_nedges + 63) / 64;
+    uint64_t *acc = calloc(nwords ? nwords : 1, sizeof(uint64_t));
+    uint64_t *tmp = malloc(COVSTORE_CHUNK_WORDS * sizeof(uint64_t));
+    if (!acc || !tmp) {
+        free(acc);
+        free(tmp);
+        return ENOMEM;
+    }
+
+    uint32_t selected = 0;
+    for (uint32_t i = 0; i < cs->nruns; i++) {
+        if (!filter_match(f, &cs->runs[i])) {
+            continue;
+        }
+        const uint8_t *blob = covstore_blob(cs, &cs->runs[i]);
+        if (!blob) {
+            printf("경고: run %u 의 비트맵이 손상되었습니다.\n", i);
+            continue;
+        }
+        if (is_union || selected == 0) {
+            acc_or_blob(acc, nwords, blob);
+        } else {
+            acc_and_blob(acc, nwords, blob, tmp);
+        }
+        selected++;
+    }
+
+    printf("선택된 run 수: %u\n", selected);
+    printf("%s 엣지 수: %llu / %u\n", is_union ? "합집합" : "교집합",
+           (unsigned long long)words_popcount(acc, nwords), cs->hdr->ci_nedges);
+    print_edges(acc, nwords, 20);
+
+    free(tmp);
+    free(acc);
+    return 0;
+}
+
+static int cmd_who_hit(const covstore_t *cs, const covstore_filter_t *f, uint32_t edge) {
+    if (edge >= cs->hdr->ci_nedges) {
+        return EINVAL;
+    }
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < cs->nruns; i++) {
+        const covstore_run_t *r = &cs->runs[i];
+        if (!filter_match(f, r)) {
+            continue;
+        }
+        const uint8_t *blob = covstore_blob(cs, r);
+        if (blob && blob_contains(blob, edge)) {
+            if (count < 50) {
+                printf("  run %u: program=%.*s mode=%s ts=%llu\n", r->cr_run_id,
+                       COVSTORE_PROGRAM_LEN, r->cr_program, mode_name(r->cr_mode),
+                       (unsigned long long)r->cr_timestamp);
+            }
+            count++;
+        }
+    }
+    printf("엣지 %u 을(를) 히트한 run 수: %u\n", edge, count);
+    return 0;
+}
+
+/* run_id 만 히트한 엣지 = run_id - (필터에 맞는 다른 run 들의 합집합) */
+static int cmd_unique(const covstore_t *cs, const covstore_filter_t *f, uint32_t run_id) {
+    if (run_id >= cs->nruns) {
+        return EINVAL;
+    }
+    const uint8_t *target = covstore_blob(cs, &cs->runs[run_id]);
+    if (!target) {
+        return EINVAL;
+    }
+
+    size_t nwords = ((size_t)cs->hdr->ci_nedges + 63) / 64;
+    uint64_t *others = calloc(nwords ? nwords : 1, sizeof(uint64_t));
+    uint64_t *mine = calloc(nwords ? nwords : 1, sizeof(uint64_t));
+    if (!others || !mine) {
+        free(others);
+        free(mine);
+        return ENOMEM;
+    }
+
+    for (uint32_t i = 0; i < cs->nruns; i++) {
+        if (i == run_id || !filter_match(f, &cs->runs[i])) {
+            continue;
+        }
+        const uint8_t *blob = covstore_blob(cs, &cs->runs[i]);
+        if (blob) {
+            acc_or_blob(others, nwords, blob);
+        }
+    }
+    acc_or_blob(mine, nwords, target);
+    words_andnot(mine, others, nwords);
+
+    printf("run %u 만 히트한 엣지 수: %llu\n", run_id,
+           (unsigned long long)words_popcount(mine, nwords));
+    print_edges(mine, nwords, 20);
+
+    free(mine);
+    free(others);
+    return 0;
+}
+
+/* ---- 수집 ---- */
+
+/*
+ * COUNTERS 모드로 한 번 측정하고 결과를 저장합니다.
+ * argv 가 주어지면 자식 프로세스에서 해당 프로그램을 실행하고, 없으면 getppid() 를 측정합니다.
+ */
+static int cmd_record(const char *dir, const char *label, char **argv) {
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open");
+        return errno;
+    }
+
+    int ret = ksancov_mode_counters(fd);
+    if (ret != 0) {
+        printf("COUNTERS 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+
+    uintptr_t buf = 0;
+    ret = ksancov_map(fd, &buf, NULL);
+    if (ret != 0) {
+        printf("버퍼 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    ksancov_counters_t *counters = (ksancov_counters_t *)buf;
+    memset(counters->kc_hits, 0, counters->kc_nedges);
+
+    if (argv && argv[0]) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            if (ksancov_thread_self(fd) != 0) {
+                _exit(127);
+            }
+            ksancov_start(counters);
+            execvp(argv[0], argv);
+            _exit(127);
+        } else if (pid < 0) {
+            ret = errno;
+            close(fd);
+            return ret;
+        }
+        int status;
+        waitpid(pid, &status, 0);
+        ksancov_stop(counters);
+    } else {
+        ret = ksancov_thread_self(fd);
+        if (ret != 0) {
+            printf("스레드 설정 실패: %s\n", strerror(ret));
+            close(fd);
+            return ret;
+        }
+        ksancov_start(counters);
+        getppid();
+        ksancov_stop(counters);
+    }
+
+    const char *program = label ? label : (argv && argv[0] ? argv[0] : "getppid");
+    ret = covstore_append(dir, counters->kc_hits, counters->kc_nedges,
+                          COVSTORE_MODE_COUNTERS, program, NULL);
+    close(fd);
+    return ret;
+}
+
+/* nedges 바이트짜리 kc_hits 덤프 파일을 run 으로 가져옵니다. */
+static int cmd_import(const char *dir, const char *file, const char *program, uint32_t mode) {
+    int fd = open(file, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        int ret = errno;
+        if (fd >= 0) {
+            close(fd);
+        }
+        return ret;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return EINVAL;
+    }
+    void *p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        int ret = errno;
+        close(fd);
+        return ret;
+    }
+    int ret = covstore_append(dir, p, (size_t)st.st_size, mode, program ? program : file, NULL);
+    munmap(p, (size_t)st.st_size);
+    close(fd);
+    return ret;
+}
+
+static void usage(const char *prog) {
+    printf("사용법: %s [-d 저장소] 명령 [인자...]\n", prog);
+    printf("  record [--label 이름] [--exec 프로그램 [인자...]]\n");
+    printf("  import <hits.bin> [--program 이름] [--mode counters|trace]\n");
+    printf("  list\n");
+    printf("  union     [--program 이름] [--mode 모드] [--since ts] [--until ts]\n");
+    printf("  intersect [--program 이름] [--mode 모드] [--since ts] [--until ts]\n");
+    printf("  who-hit <edge> [필터...]\n");
+    printf("  unique <run_id> [필터...]\n");
+}
+
+/* 메인 함수 */
+int main(int argc, char *argv[]) {
+    const char *dir = "covstore";
+    int i = 1;
+
+    if (i + 1 < argc && strcmp(argv[i], "-d") == 0) {
+        dir = argv[i + 1];
+        i += 2;
+    }
+    if (i >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *cmd = argv[i++];
+
+    if (strcmp(cmd, "record") == 0) {
+        const char *label = NULL;
+        char **exec_argv = NULL;
+        for (; i < argc; i++) {
+            if (strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+                label = argv[++i];
+            } else if (strcmp(argv[i], "--exec") == 0 && i + 1 < argc) {
+                exec_argv = &argv[i + 1];
+                break;
+            }
+        }
+        int ret = cmd_record(dir, label, exec_argv);
+        if (ret != 0) {
+            printf("record 실패: %s\n", strerror(ret));
+        }
+        return ret;
+    }
+
+    if (strcmp(cmd, "import") == 0) {
+        if (i >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *file = argv[i++];
+        const char *program = NULL;
+        uint32_t mode = COVSTORE_MODE_COUNTERS;
+        for (; i + 1 < argc; i += 2) {
+            if (strcmp(argv[i], "--program") == 0) {
+                program = argv[i + 1];
+            } else if (strcmp(argv[i], "--mode") == 0) {
+                mode = mode_from_name(argv[i + 1]);
+            }
+        }
+        int ret = mode ? cmd_import(dir, file, program, mode) : EINVAL;
+        if (ret != 0) {
+            printf("import 실패: %s\n", strerror(ret));
+        }
+        return ret;
+    }
+
+    /* 나머지 명령은 위치 인자 하나(선택)와 필터를 받음 */
+    const char *positional = NULL;
+    if ((strcmp(cmd, "who-hit") == 0 || strcmp(cmd, "unique") == 0) && i < argc) {
+        positional = argv[i++];
+    }
+    covstore_filter_t filter = {0};
+    for (; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--program") == 0) {
+            filter.program = argv[i + 1];
+        } else if (strcmp(argv[i], "--mode") == 0) {
+            filter.mode = mode_from_name(argv[i + 1]);
+        } else if (strcmp(argv[i], "--since") == 0) {
+            filter.since = strtoull(argv[i + 1], NULL, 0);
+        } else if (strcmp(argv[i], "--until") == 0) {
+            filter.until = strtoull(argv[i + 1], NULL, 0);
+        }
+    }
+
+    covstore_t cs;
+    int ret = covstore_open(&cs, dir);
+    if (ret != 0) {
+        printf("저장소 열기 실패 (%s): %s\n", dir, strerror(ret));
+        return ret;
+    }
+
+    if (strcmp(cmd, "list") == 0) {
+        ret = cmd_list(&cs);
+    } else if (strcmp(cmd, "union") == 0) {
+        ret = cmd_setop(&cs, &filter, 1);
+    } else if (strcmp(cmd, "intersect") == 0) {
+        ret = cmd_setop(&cs, &filter, 0);
+    } else if (strcmp(cmd, "who-hit") == 0 && positional) {
+        ret = cmd_who_hit(&cs, &filter, (uint32_t)strtoul(positional, NULL, 0));
+    } else if (strcmp(cmd, "unique") == 0 && positional) {
+        ret = cmd_unique(&cs, &filter, (uint32_t)strtoul(positional, NULL, 0));
+    } else {
+        usage(argv[0]);
+        ret = 1;
+    }
+    if (ret != 0 && ret != 1) {
+        printf("%s 실패: %s\n", cmd, strerror(ret));
+    }
+
+    covstore_close(&cs);
+    return ret;
+}
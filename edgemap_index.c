@@ -0,0 +1,845 @@
+/*
+ * 역방향 엣지맵 인덱스 (PC -> 엣지 인덱스)
+ *
+ * ksancov_edge_addr() 는 엣지 인덱스 -> PC 방향만 제공하므로, TRACE 모드의 kt_entries PC 를
+ * COUNTERS 모드의 가드 인덱스로 되돌릴 방법이 없습니다. 이 도구는 ke_addrs[] 로부터
+ * PC -> 인덱스 해시 테이블을 커널마다 한 번 만들어 디스크에 캐시하고(mmap 으로 바로 재사용),
+ * TRACE 버퍼 전체를 엣지별 히트 배열로 일괄 변환합니다.
+ *
+ * 인덱스는 8바이트 슬롯(가장 작은 엣지 PC 기준 32비트 오프셋, 인덱스)의 open addressing
+ * 테이블이며 적재율을 50% 이하로 둡니다. TRACE 는 대부분 다음 가드로 순차 진행하므로 변환은
+ * 먼저 직전 엣지의 다음 인덱스와 비교하고, 먼 점프만 해시 탐색하되 블록 파이프라인으로
+ * 미리 prefetch 하여 메모리 지연을 겹칩니다.
+ *
+ * 캐시 파일 이름은 커널 식별자(kern.uuid, kern.version)와 ke_nedges 로 정하므로 커널마다 하나입니다.
+ * ke_addrs[] 는 가드가 처음 실행될 때 채워지므로, 캐시를 열 때마다 그 뒤 새로 채워진 엣지만
+ * 인덱스에 추가합니다(파일을 새로 만들지 않음). 이미 있던 엣지 주소가 달라졌을 때만 다시 만듭니다.
+ * TRACE PC 와 ke_addrs 는 같은 주소 표현(가드 호출 지점)이라고 가정합니다.
+ *
+ * 컴파일: gcc -O2 -o edgemap_index edgemap_index.c
+ * 실행:
+ *   sudo ./edgemap_index build [-c 캐시디렉토리]
+ *   sudo ./edgemap_index convert trace.bin hits.bin [-c 캐시디렉토리]
+ *   sudo ./edgemap_index bench [-n PC수] [-c 캐시디렉토리]
+ *   ./edgemap_index bench --synthetic 엣지수 [-n PC수]
+ *
+ * convert 의 출력(hits.bin)은 nedges 바이트짜리 kc_hits 와 같은 형식(255 포화)이므로
+ * coverage_store import hits.bin --mode trace 처럼 COUNTERS 기반 도구에 그대로 넣을 수 있습니다.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+/* ksancov 헤더 파일에서 필요한 정의들 */
+#define KSANCOV_PATH "/dev/ksancov"
+
+/* ioctl 명령어들 */
+#define KSANCOV_IOC_COUNTERS     _IO('K', 2)
+#define KSANCOV_IOC_MAP_EDGEMAP  _IOWR('K', 9, struct ksancov_buf_desc)
+
+/* 매직 넘버들 */
+#define KSANCOV_EDGEMAP_MAGIC   (uint32_t)0x5AD37F7BU
+
+/* 버퍼 설명자 */
+struct ksancov_buf_desc {
+    uintptr_t ptr;
+    size_t sz;
+};
+
+/* 엣지 매핑 구조체 */
+typedef struct ksancov_edgemap {
+    uint32_t  ke_magic;
+    uint32_t  ke_nedges;
+    uintptr_t ke_addrs[];
+} ksancov_edgemap_t;
+
+/* 인덱스 포맷 */
+#define EDGEIDX_MAGIC        (uint32_t)0x58494445U   /* "EDIX" */
+#define EDGEIDX_VERSION      3
+#define EDGEIDX_HASH_MULT    0x9E3779B1U
+#define EDGEIDX_EMPTY        UINT32_MAX              /* 빈 슬롯의 es_off */
+#define EDGEIDX_BLOCK        64      /* 변환 단계 묶음 크기 (prefetch 거리) */
+#define EDGEIDX_NEAR         4096    /* 이전 PC 와 이 거리 안이면 순차 경로로 보고 prefetch 생략 */
+#define EDGEIDX_KERNEL_LEN   128
+
+/*
+ * 파일 레이아웃: 헤더 | uint32_t 오프셋[ei_nedges] (인덱스 -> PC - ei_base) | 슬롯[ei_nslots]
+ * 오프셋 배열은 "다음 PC 가 다음 엣지" 인 빠른 경로에 사용합니다.
+ */
+typedef struct edgeidx_header {
+    uint32_t ei_magic;
+    uint32_t ei_version;
+    uint32_t ei_nedges;
+    uint32_t ei_shift;               /* 32 - log2(ei_nslots) */
+    uint64_t ei_nslots;
+    uint64_t ei_key;                 /* 커널 식별자 + ke_nedges 해시 (캐시 키) */
+    uint64_t ei_base;                /* 가장 작은 ke_addrs 값 */
+    char     ei_kernel[EDGEIDX_KERNEL_LEN];
+} edgeidx_header_t;
+
+/* 8바이트 슬롯: 커널 텍스트는 4GB 안에 있으므로 PC 는 ei_base 기준 32비트 오프셋으로 저장 */
+typedef struct edgeidx_slot {
+    uint32_t es_off;                 /* EDGEIDX_EMPTY 이면 빈 슬롯 */
+    uint32_t es_idx;
+} edgeidx_slot_t;
+
+typedef struct edgeidx {
+    void                 *map;
+    size_t                map_size;
+    const edgeidx_header_t *hdr;
+    uint32_t             *offs;
+    edgeidx_slot_t       *slots;
+    int                   fd;        /* 사용하는 동안 공유 잠금 유지 */
+    uint64_t              base;
+    uint32_t              mask;
+    uint32_t              shift;
+    uint32_t              nedges;
+} edgeidx_t;
+
+/* 헬퍼 함수들 */
+static int ksancov_open(void) {
+    return open(KSANCOV_PATH, O_RDWR);
+}
+
+static int ksancov_map_edgemap(int fd, uintptr_t *buf, size_t *sz) {
+    struct ksancov_buf_desc mc = {0};
+    int ret = ioctl(fd, KSANCOV_IOC_MAP_EDGEMAP, &mc);
+    if (ret == -1) {
+        return errno;
+    }
+    *buf = mc.ptr;
+    if (sz) {
+        *sz = mc.sz;
+    }
+    return 0;
+}
+
+static int ksancov_mode_counters(int fd) {
+    int ret = ioctl(fd, KSANCOV_IOC_COUNTERS);
+    return (ret == -1) ? errno : 0;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- 인덱스 생성 / 로드 ---- */
+
+/* 캐시 키: 커널 식별자 문자열과 엣지 수의 FNV-1a 해시 */
+static uint64_t cache_key(const char *ident, uint32_t nedges) {
+    uint64_t x = 0xcbf29ce484222325ULL ^ nedges;
+    for (const char *c = ident; *c; c++) {
+        x = (x ^ (uint8_t)*c) * 0x100000001b3ULL;
+    }
+    return x;
+}
+
+static inline uint32_t edgeidx_slot_of(uint32_t off, uint32_t shift) {
+    return (off * EDGEIDX_HASH_MULT) >> shift;
+}
+
+static void kernel_version(char *out, size_t len) {
+    snprintf(out, len, "unknown");
+#if defined(__APPLE__)
+    size_t sz = len;
+    if (sysctlbyname("kern.version", out, &sz, NULL, 0) != 0) {
+        snprintf(out, len, "unknown");
+    }
+    out[len - 1] = '\0';
+#endif
+}
+
+/* 캐시 키로 쓰는 커널 식별자: kern.uuid (있으면) + kern.version */
+static void kernel_identity(char *out, size_t len) {
+    char version[160];
+    char uuid[64] = "";
+    kernel_version(version, sizeof(version));
+#if defined(__APPLE__)
+    size_t sz = sizeof(uuid);
+    if (sysctlbyname("kern.uuid", uuid, &sz, NULL, 0) != 0) {
+        uuid[0] = '\0';
+    }
+    uuid[sizeof(uuid) - 1] = '\0';
+#endif
+    snprintf(out, len, "%s%s%s", uuid, uuid[0] ? " " : "", version);
+}
+
+static size_t edgeidx_file_size(uint32_t nedges, uint64_t nslots) {
+    return sizeof(edgeidx_header_t) + (size_t)nedges * sizeof(uint32_t) + nslots * sizeof(edgeidx_slot_t);
+}
+
+static void edgeidx_attach(edgeidx_t *ix, void *map, size_t size, int fd) {
+    ix->map = map;
+    ix->map_size = size;
+    ix->fd = fd;
+    ix->hdr = (const edgeidx_header_t *)map;
+    ix->offs = (uint32_t *)((uint8_t *)map + sizeof(edgeidx_header_t));
+    ix->slots = (edgeidx_slot_t *)(ix->offs + ix->hdr->ei_nedges);
+    ix->base = ix->hdr->ei_base;
+    ix->mask = (uint32_t)(ix->hdr->ei_nslots - 1);
+    ix->shift = ix->hdr->ei_shift;
+    ix->nedges = ix->hdr->ei_nedges;
+}
+
+static void edgeidx_close(edgeidx_t *ix) {
+    if (ix->map) {
+        munmap(ix->map, ix->map_size);
+        close(ix->fd);
+    }
+    memset(ix, 0, sizeof(*ix));
+}
+
+/* 슬롯에 off -> idx 추가. 같은 PC 가 이미 있으면 0 (첫 번째 가드 인덱스 유지) */
+static int edgeidx_insert(edgeidx_slot_t *slots, uint32_t mask, uint32_t shift, uint32_t off, uint32_t idx) {
+    uint32_t s = edgeidx_slot_of(off, shift);
+    while (slots[s].es_off != EDGEIDX_EMPTY && slots[s].es_off != off) {
+        s = (s + 1) & mask;
+    }
+    if (slots[s].es_off == off) {
+        return 0;
+    }
+    slots[s].es_off = off;
+    slots[s].es_idx = idx;
+    return 1;
+}
+
+/*
+ * 캐시 파일을 mmap 으로 로드. 없거나 맞지 않으면 ENOENT.
+ * 다른 프로세스가 쓰고 있지 않으면 배타 잠금을 잡아 쓰기 가능하게 매핑하고 *exclusive = 1,
+ * 아니면 공유 잠금만 잡고 읽기 전용으로 매핑합니다.
+ */
+static int edgeidx_load(edgeidx_t *ix, const char *path, uint64_t key, uint32_t nedges, int *exclusive) {
+    int writable = 1;
+    *exclusive = 0;
+    int fd = open(path, O_RDWR);
+    if (fd < 0 && errno == EACCES) {
+        writable = 0;
+        fd = open(path, O_RDONLY);
+    }
+    if (fd < 0) {
+        return errno;
+    }
+    *exclusive = writable && flock(fd, LOCK_EX | LOCK_NB) == 0;
+    if (!*exclusive && flock(fd, LOCK_SH) != 0) {
+        int ret = errno;
+        close(fd);
+        return ret;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(edgeidx_header_t)) {
+        close(fd);
+        return ENOENT;
+    }
+    void *map = mmap(NULL, (size_t)st.st_size, *exclusive ? PROT_READ | PROT_WRITE : PROT_READ,
+                     MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        int ret = errno;
+        close(fd);
+        return ret;
+    }
+    const edgeidx_header_t *h = map;
+    if (h->ei_magic != EDGEIDX_MAGIC || h->ei_version != EDGEIDX_VERSION ||
+        h->ei_key != key || h->ei_nedges != nedges ||
+        edgeidx_file_size(h->ei_nedges, h->ei_nslots) != (size_t)st.st_size) {
+        munmap(map, (size_t)st.st_size);
+        close(fd);
+        return ENOENT;
+    }
+    edgeidx_attach(ix, map, (size_t)st.st_size, fd);
+    return 0;
+}
+
+/*
+ * 캐시된 인덱스를 현재 ke_addrs[] 에 맞춤. 인덱스를 만든 뒤 처음 실행된 가드의 엣지만
+ * 슬롯에 추가합니다 (슬롯 수를 ke_nedges 기준으로 잡았으므로 적재율은 50% 이하로 유지).
+ * 이미 있던 엣지의 주소가 다르거나 새 주소가 32비트 오프셋 범위를 벗어나면 ESTALE.
+ * 배타 잠금이 없으면 추가하지 않고 추가할 엣지 수만 *pending 에 돌려줍니다.
+ */
+static int edgeidx_update(edgeidx_t *ix, const ksancov_edgemap_t *em, int exclusive,
+                          uint32_t *added, uint32_t *pending) {
+    uint32_t fresh = 0;
+    *added = 0;
+    *pending = 0;
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        uint64_t pc = (uint64_t)em->ke_addrs[i];
+        if (pc == 0) {
+            continue;
+        }
+        uint64_t d = pc - ix->base;
+        if (ix->offs[i] != EDGEIDX_EMPTY) {
+            if (ix->offs[i] != d) {
+                return ESTALE;
+            }
+        } else if (d >= EDGEIDX_EMPTY) {
+            return ESTALE;
+        } else {
+            fresh++;
+        }
+    }
+    if (fresh == 0) {
+        return 0;
+    }
+    if (!exclusive) {
+        *pending = fresh;
+        return 0;
+    }
+
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        uint64_t pc = (uint64_t)em->ke_addrs[i];
+        if (pc == 0 || ix->offs[i] != EDGEIDX_EMPTY) {
+            continue;
+        }
+        uint32_t off = (uint32_t)(pc - ix->base);
+        edgeidx_insert(ix->slots, ix->mask, ix->shift, off, i);
+        ix->offs[i] = off;
+    }
+    *added = fresh;
+    return msync(ix->map, ix->map_size, MS_SYNC) == 0 ? 0 : errno;
+}
+
+/* ke_addrs[] 로 인덱스를 만들어 path 에 저장하고 mmap 으로 연결 (공유 잠금 상태로 반환) */
+static int edgeidx_build(edgeidx_t *ix, const char *path, const ksancov_edgemap_t *em,
+                         uint64_t key, const char *ident) {
+    uint64_t lo = UINT64_MAX, hi = 0;
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        uint64_t pc = (uint64_t)em->ke_addrs[i];
+        if (pc == 0) {
+            continue;
+        }
+        lo = pc < lo ? pc : lo;
+        hi = pc > hi ? pc : hi;
+    }
+    /*
+     * 아직 채워지지 않은 엣지가 나중에 추가될 수 있도록 알려진 주소 범위를 32비트 창의
+     * 가운데에 둡니다. 채워진 엣지가 없으면 base 0 으로 두고 첫 추가 때 다시 만듭니다.
+     */
+    uint64_t base = 0;
+    if (lo != UINT64_MAX) {
+        if (hi - lo >= EDGEIDX_EMPTY) {
+            printf("엣지 주소 범위가 32비트 오프셋을 넘습니다\n");
+            return EOVERFLOW;
+        }
+        uint64_t slack = (EDGEIDX_EMPTY - 1 - (hi - lo)) / 2;
+        base = lo > slack ? lo - slack : 0;
+    }
+
+    uint32_t bits = 4;
+    while ((1ULL << bits) < (uint64_t)em->ke_nedges * 2) {
+        bits++;
+    }
+    if (bits > 31) {
+        return EOVERFLOW;
+    }
+    uint64_t nslots = 1ULL << bits;
+    size_t size = edgeidx_file_size(em->ke_nedges, nslots);
+
+    char tmp[1100];
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return errno;
+    }
+    if (flock(fd, LOCK_SH) != 0 || ftruncate(fd, (off_t)size) != 0) {
+        int ret = errno;
+        close(fd);
+        unlink(tmp);
+        return ret;
+    }
+    void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (map == MAP_FAILED) {
+        int ret = errno;
+        close(fd);
+        unlink(tmp);
+        return ret;
+    }
+
+    edgeidx_header_t *h = map;
+    h->ei_magic = EDGEIDX_MAGIC;
+    h->ei_version = EDGEIDX_VERSION;
+    h->ei_nedges = em->ke_nedges;
+    h->ei_shift = 32 - bits;
+    h->ei_nslots = nslots;
+    h->ei_key = key;
+    h->ei_base = base;
+    snprintf(h->ei_kernel, sizeof(h->ei_kernel), "%.*s",   /* 표시용 (잘려도 무방) */
+             (int)sizeof(h->ei_kernel) - 1, ident);
+
+    uint32_t *offs = (uint32_t *)((uint8_t *)map + sizeof(*h));
+    edgeidx_slot_t *slots = (edgeidx_slot_t *)(offs + em->ke_nedges);
+    memset(slots, 0xff, nslots * sizeof(edgeidx_slot_t));
+    uint32_t mask = (uint32_t)(nslots - 1);
+    uint32_t dups = 0;
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        uint64_t pc = (uint64_t)em->ke_addrs[i];
+        if (pc == 0) {
+            offs[i] = EDGEIDX_EMPTY;
+            continue;
+        }
+        uint32_t off = (uint32_t)(pc - base);
+        offs[i] = off;
+        if (!edgeidx_insert(slots, mask, h->ei_shift, off, i)) {
+            dups++;
+        }
+    }
+    if (dups) {
+        printf("경고: 중복 PC %u개 (첫 번째 인덱스로 매핑)\n", dups);
+    }
+
+    if (msync(map, size, MS_SYNC) != 0 || rename(tmp, path) != 0) {
+        int ret = errno;
+        munmap(map, size);
+        close(fd);
+        unlink(tmp);
+        return ret;
+    }
+    edgeidx_attach(ix, map, size, fd);
+    return 0;
+}
+
+/*
+ * 커널 식별자와 엣지 수로 캐시를 찾아 로드하고 새로 채워진 엣지를 추가합니다.
+ * 캐시가 없거나 현재 엣지맵과 맞지 않을 때만 (같은 이름으로) 다시 만듭니다.
+ */
+static int edgeidx_open(edgeidx_t *ix, const char *cache_dir, const ksancov_edgemap_t *em,
+                        const char *ident, int *built, uint32_t *added) {
+    char path[1024];
+    uint64_t key = cache_key(ident, em->ke_nedges);
+
+    *built = 0;
+    *added = 0;
+    if (mkdir(cache_dir, 0755) != 0 && errno != EEXIST) {
+        return errno;
+    }
+    snprintf(path, sizeof(path), "%s/edgemap_%016llx.idx", cache_dir, (unsigned long long)key);
+
+    int exclusive;
+    if (edgeidx_load(ix, path, key, em->ke_nedges, &exclusive) == 0) {
+        uint32_t pending;
+        int ret = edgeidx_update(ix, em, exclusive, added, &pending);
+        if (exclusive) {
+            flock(ix->fd, LOCK_SH);     /* 추가가 끝났으니 다른 프로세스도 읽을 수 있게 */
+        }
+        if (ret == 0) {
+            if (pending) {
+                printf("경고: 다른 프로세스가 인덱스를 사용 중이라 새 엣지 %u개를 추가하지 못했습니다\n",
+                       pending);
+            }
+            return 0;
+        }
+        edgeidx_close(ix);
+        if (ret != ESTALE) {
+            return ret;
+        }
+        printf("캐시된 인덱스가 현재 엣지맵과 맞지 않아 다시 만듭니다\n");
+    }
+    *built = 1;
+    return edgeidx_build(ix, path, em, key, ident);
+}
+
+/* ---- 조회 / 일괄 변환 ---- */
+
+/* PC 하나의 엣지 인덱스 (없으면 -1) */
+static inline int64_t edgeidx_lookup(const edgeidx_t *ix, uint64_t pc) {
+    uint64_t d = pc - ix->base;
+    if (d >= EDGEIDX_EMPTY) {
+        return -1;
+    }
+    uint32_t off = (uint32_t)d;
+    for (uint32_t s = edgeidx_slot_of(off, ix->shift);; s = (s + 1) & ix->mask) {
+        const edgeidx_slot_t *e = &ix->slots[s];
+        if (e->es_off == off) {
+            return e->es_idx;
+        }
+        if (e->es_off == EDGEIDX_EMPTY) {
+            return -1;
+        }
+    }
+}
+
+/* 변환 파이프라인의 블록 하나 (EDGEIDX_BLOCK 개 PC) */
+typedef struct edgeidx_block {
+    const uint64_t *pcs;
+    uint32_t        count;
+    uint32_t        nfar;
+    uint32_t        far_pos[EDGEIDX_BLOCK];
+    int64_t         far_idx[EDGEIDX_BLOCK];    /* 먼 점프의 2단계 결과 */
+} edgeidx_block_t;
+
+/* 1단계: 직전 PC 에서 EDGEIDX_NEAR 이상 떨어진 먼 점프 위치를 모으고 슬롯 prefetch */
+static void edgeidx_stage_scan(const edgeidx_t *ix, edgeidx_block_t *b, uint64_t *prev) {
+    uint32_t nfar = 0;
+    for (uint32_t k = 0; k < b->count; k++) {
+        uint64_t pc = b->pcs[k];
+        if (pc - *prev + EDGEIDX_NEAR > 2 * EDGEIDX_NEAR) {
+            b->far_pos[nfar++] = k;
+            uint64_t d = pc - ix->base;
+            if (d < EDGEIDX_EMPTY) {
+                __builtin_prefetch(&ix->slots[edgeidx_slot_of((uint32_t)d, ix->shift)]);
+            }
+        }
+        *prev = pc;
+    }
+    b->nfar = nfar;
+}
+
+/* 2단계: 먼 점프의 인덱스를 구하고 누적할 hits[] 와 다음 오프셋 prefetch */
+static void edgeidx_stage_resolve(const edgeidx_t *ix, edgeidx_block_t *b, uint32_t *hits) {
+    for (uint32_t f = 0; f < b->nfar; f++) {
+        int64_t r = edgeidx_lookup(ix, b->pcs[b->far_pos[f]]);
+        b->far_idx[f] = r;
+        if (r >= 0) {
+            __builtin_prefetch(&hits[r], 1);
+            __builtin_prefetch(&ix->offs[r + 1]);
+        }
+    }
+}
+
+/* 3단계: 순서대로 누적 (먼 점프는 2단계 결과, 나머지는 빠른 경로) */
+static uint64_t edgeidx_stage_apply(const edgeidx_t *ix, const edgeidx_block_t *b,
+                                    uint32_t *hits, uint32_t *last) {
+    const uint32_t *offs = ix->offs;
+    uint64_t unmatched = 0;
+    uint32_t cur = *last;
+    uint32_t f = 0;
+
+    for (uint32_t k = 0; k < b->count; k++) {
+        int64_t idx;
+        if (f < b->nfar && b->far_pos[f] == k) {
+            idx = b->far_idx[f++];
+        } else {
+            uint64_t d = b->pcs[k] - ix->base;
+            uint32_t next = cur + 1;
+            if (next < ix->nedges && offs[next] == d) {
+                idx = next;
+            } else if (offs[cur] == d && d < EDGEIDX_EMPTY) {
+                idx = cur;
+            } else {
+                idx = edgeidx_lookup(ix, b->pcs[k]);
+            }
+        }
+        if (idx < 0) {
+            unmatched++;
+            continue;
+        }
+        hits[idx]++;
+        cur = (uint32_t)idx;
+    }
+    *last = cur;
+    return unmatched;
+}
+
+/*
+ * PC 배열을 엣지별 히트 수로 일괄 변환 (hits[] 에 누적).
+ *
+ * TRACE 는 대부분 같은 함수 안에서 다음 가드로 진행하므로, 직전 엣지의 다음(또는 같은)
+ * 인덱스의 오프셋과 먼저 비교하는 빠른 경로로 해시 탐색을 건너뜁니다.
+ * 먼 점프만 세 단계 파이프라인으로 처리하며, 블록 b 를 누적하는 동안 블록 b+1 은 슬롯 탐색,
+ * 블록 b+2 는 슬롯 prefetch 중이므로 캐시 미스가 앞 블록의 작업과 겹칩니다.
+ * 순차 구간은 추가 캐시 라인을 끌어오지 않습니다.
+ * 매칭되지 않은 PC 수를 반환합니다.
+ */
+static uint64_t edgeidx_convert(const edgeidx_t *ix, const uint64_t *pcs, size_t n, uint32_t *hits) {
+    edgeidx_block_t blk[3];
+    size_t nblocks = (n + EDGEIDX_BLOCK - 1) / EDGEIDX_BLOCK;
+    uint64_t unmatched = 0;
+    uint64_t prev = 0;
+    uint32_t last = 0;
+
+    for (size_t b = 0; b < nblocks + 2; b++) {
+        if (b < nblocks) {
+            edgeidx_block_t *s = &blk[b % 3];
+            size_t start = b * EDGEIDX_BLOCK;
+            s->pcs = pcs + start;
+            s->count = (uint32_t)(n - start < EDGEIDX_BLOCK ? n - start : EDGEIDX_BLOCK);
+            edgeidx_stage_scan(ix, s, &prev);
+        }
+        if (b >= 1 && b - 1 < nblocks) {
+            edgeidx_stage_resolve(ix, &blk[(b - 1) % 3], hits);
+        }
+        if (b >= 2) {
+            unmatched += edgeidx_stage_apply(ix, &blk[(b - 2) % 3], hits, &last);
+        }
+    }
+    return unmatched;
+}
+
+/* ---- 명령 ---- */
+
+static int map_device_edgemap(ksancov_edgemap_t **out, int *out_fd) {
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open");
+        return errno;
+    }
+    int ret = ksancov_mode_counters(fd);
+    if (ret != 0) {
+        printf("COUNTERS 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    uintptr_t buf = 0;
+    ret = ksancov_map_edgemap(fd, &buf, NULL);
+    if (ret != 0) {
+        printf("엣지맵 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    *out = (ksancov_edgemap_t *)buf;
+    *out_fd = fd;
+    return 0;
+}
+
+/* 디바이스 없이 벤치마크할 수 있도록 커널과 비슷한 분포의 가짜 엣지맵 생성 */
+static ksancov_edgemap_t *synthetic_edgemap(uint32_t nedges) {
+    ksancov_edgemap_t *em = malloc(sizeof(*em) + (size_t)nedges * sizeof(uintptr_t));
+    if (!em) {
+        return NULL;
+    }
+    em->ke_magic = KSANCOV_EDGEMAP_MAGIC;
+    em->ke_nedges = nedges;
+    uint64_t pc = 0xfffffe0007004000ULL;
+    uint64_t r = 0x2545F4914F6CDD1DULL;
+    for (uint32_t i = 0; i < nedges; i++) {
+        r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+        pc += 4 + (r % 16) * 4;
+        em->ke_addrs[i] = (uintptr_t)pc;
+    }
+    return em;
+}
+
+static void print_index_info(const edgeidx_t *ix, int built, uint32_t added, double build_ms) {
+    printf("인덱스 %s: 엣지 %u, 슬롯 %llu (%.1f MB), 커널: %.60s\n",
+           built ? "생성" : added ? "캐시 로드 후 갱신" : "캐시 로드", ix->hdr->ei_nedges,
+           (unsigned long long)ix->hdr->ei_nslots,
+           (double)ix->map_size / (1024.0 * 1024.0), ix->hdr->ei_kernel);
+    if (added) {
+        printf("새로 채워진 엣지 %u개 추가\n", added);
+    }
+    printf("소요 시간: %.2f ms\n", build_ms);
+}
+
+static int cmd_convert(const edgeidx_t *ix, const char *in_path, const char *out_path) {
+    int fd = open(in_path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        int ret = errno;
+        if (fd >= 0) close(fd);
+        return ret;
+    }
+    size_t n = (size_t)st.st_size / sizeof(uint64_t);
+    const uint64_t *pcs = NULL;
+    if (n) {
+        pcs = mmap(NULL, n * sizeof(uint64_t), PROT_READ, MAP_SHARED, fd, 0);
+        if (pcs == MAP_FAILED) {
+            int ret = errno;
+            close(fd);
+            return ret;
+        }
+        madvise((void *)pcs, n * sizeof(uint64_t), MADV_SEQUENTIAL);
+    }
+    close(fd);
+
+    uint32_t nedges = ix->hdr->ei_nedges;
+    uint32_t *hits = calloc(nedges ? nedges : 1, sizeof(uint32_t));
+    uint8_t *out = malloc(nedges ? nedges : 1);
+    if (!hits || !out) {
+        free(hits);
+        free(out);
+        return ENOMEM;
+    }
+
+    uint64_t t0 = now_ns();
+    uint64_t unmatched = n ? edgeidx_convert(ix, pcs, n, hits) : 0;
+    double sec = (double)(now_ns() - t0) / 1e9;
+
+    uint32_t hit_edges = 0;
+    for (uint32_t i = 0; i < nedges; i++) {
+        out[i] = hits[i] > UINT8_MAX ? UINT8_MAX : (uint8_t)hits[i];
+        hit_edges += hits[i] != 0;
+    }
+
+    int ret = 0;
+    errno = 0;      /* 짧은 쓰기는 errno 를 바꾸지 않으므로 */
+    FILE *f = fopen(out_path, "wb");
+    if (!f || fwrite(out, 1, nedges, f) != nedges) {
+        ret = errno ? errno : EIO;
+    }
+    if (f && fclose(f) != 0 && ret == 0) {
+        ret = errno ? errno : EIO;
+    }
+
+    printf("변환 완료: PC %zu개 -> 히트 엣지 %u개 (매칭 실패 %llu), %.1f M PCs/s\n",
+           n, hit_edges, (unsigned long long)unmatched, sec > 0 ? n / sec / 1e6 : 0.0);
+    if (ret == 0) {
+        printf("kc_hits 형식으로 저장: %s\n", out_path);
+    }
+
+    if (pcs) munmap((void *)pcs, n * sizeof(uint64_t));
+    free(out);
+    free(hits);
+    return ret;
+}
+
+static int cmd_bench(const edgeidx_t *ix, const ksancov_edgemap_t *em, size_t npcs) {
+    uint64_t *pcs = malloc(npcs * sizeof(uint64_t));
+    uint32_t *hits = calloc(em->ke_nedges, sizeof(uint32_t));
+    uint32_t *live = malloc((size_t)em->ke_nedges * sizeof(uint32_t));
+    if (!pcs || !hits || !live) {
+        free(pcs);
+        free(hits);
+        free(live);
+        return ENOMEM;
+    }
+
+    /* 아직 실행되지 않은 가드(ke_addrs 가 0)는 TRACE 에 나올 수 없으므로 제외 */
+    uint32_t nlive = 0;
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        if (em->ke_addrs[i]) {
+            live[nlive++] = i;
+        }
+    }
+    if (nlive == 0) {
+        printf("채워진 엣지가 없어 벤치마크를 건너뜁니다 (추적을 한 번 실행한 뒤 다시 시도)\n");
+        free(live);
+        free(hits);
+        free(pcs);
+        return 0;
+    }
+
+    /* TRACE 와 비슷하게: 임의 위치로 점프한 뒤 짧은 연속 구간을 따라감 */
+    uint64_t r = 0x9E3779B97F4A7C15ULL;
+    uint32_t cur = 0;
+    for (size_t i = 0; i < npcs; i++) {
+        r ^= r << 13; r ^= r >> 7; r ^= r << 17;
+        if ((r & 7) == 0) {
+            cur = (uint32_t)((r >> 16) % nlive);
+        } else if (++cur >= nlive) {
+            cur = 0;
+        }
+        pcs[i] = (uint64_t)em->ke_addrs[live[cur]];
+    }
+
+    uint64_t t0 = now_ns();
+    uint64_t unmatched = edgeidx_convert(ix, pcs, npcs, hits);
+    double sec = (double)(now_ns() - t0) / 1e9;
+
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < em->ke_nedges; i++) {
+        total += hits[i];
+    }
+    printf("벤치마크: 채워진 엣지 %u/%u개, PC %zu개, %.3f초, %.1f M PCs/s (매칭 %llu, 실패 %llu)\n",
+           nlive, em->ke_nedges, npcs, sec, npcs / sec / 1e6,
+           (unsigned long long)total, (unsigned long long)unmatched);
+
+    free(live);
+    free(hits);
+    free(pcs);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    printf("사용법:\n");
+    printf("  %s build [-c 캐시디렉토리]\n", prog);
+    printf("  %s convert trace.bin hits.bin [-c 캐시디렉토리]\n", prog);
+    printf("  %s bench [-n PC수] [--synthetic 엣지수] [-c 캐시디렉토리]\n", prog);
+}
+
+/* 메인 함수 */
+int main(int argc, char *argv[]) {
+    const char *cache_dir = "edgemap_cache";
+    size_t npcs = 100 * 1000 * 1000;
+    uint32_t synthetic = 0;
+    const char *pos[2] = { NULL, NULL };
+    int npos = 0;
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *cmd = argv[1];
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            npcs = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "--synthetic") == 0 && i + 1 < argc) {
+            synthetic = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (npos < 2) {
+            pos[npos++] = argv[i];
+        }
+    }
+
+    ksancov_edgemap_t *em = NULL;
+    int dev_fd = -1;
+    int ret;
+    if (synthetic) {
+        em = synthetic_edgemap(synthetic);
+        ret = em ? 0 : ENOMEM;
+    } else {
+        ret = map_device_edgemap(&em, &dev_fd);
+    }
+    if (ret != 0) {
+        return ret;
+    }
+    if (em->ke_nedges == 0) {
+        printf("엣지맵이 비어 있습니다.\n");
+        return 1;
+    }
+
+    edgeidx_t ix;
+    char ident[256];
+    if (synthetic) {
+        snprintf(ident, sizeof(ident), "synthetic");
+    } else {
+        kernel_identity(ident, sizeof(ident));
+    }
+    int built;
+    uint32_t added;
+    uint64_t t0 = now_ns();
+    ret = edgeidx_open(&ix, cache_dir, em, ident, &built, &added);
+    if (ret != 0) {
+        printf("인덱스 준비 실패: %s\n", strerror(ret));
+        return ret;
+    }
+    print_index_info(&ix, built, added, (double)(now_ns() - t0) / 1e6);
+
+    if (strcmp(cmd, "build") == 0) {
+        ret = 0;
+    } else if (strcmp(cmd, "convert") == 0 && npos == 2) {
+        ret = cmd_convert(&ix, pos[0], pos[1]);
+    } else if (strcmp(cmd, "bench") == 0) {
+        ret = cmd_bench(&ix, em, npcs ? npcs : 1);
+    } else {
+        usage(argv[0]);
+        ret = 1;
+    }
+    if (ret != 0 && ret != 1) {
+        printf("%s 실패: %s\n", cmd, strerror(ret));
+    }
+
+    edgeidx_close(&ix);
+    if (synthetic) {
+        free(em);
+    }
+    if (dev_fd >= 0) {
+        close(dev_fd);
+    }
+    return ret;
+}
@@ -15,8 +15,11 @@
 #include <sys/ioctl.h>
 #include <fcntl.h>
 #include <stdint.h>
+#include <stddef.h>
 #include <stdatomic.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 /* ksancov 헤더 파일에서 필요한 정의들 */
 #define KSANCOV_PATH "/dev/ksancov"
@@ -422,6 +425,494 @@ static int example_fork_mode(void) {
     return 0;
 }
 
+/*
+ * 크래시 안전 누적 파일
+ *
+ * 파일 구성: [헤더 A 페이지][헤더 B 페이지][PC 슬롯 테이블]
+ * 슬롯 테이블은 MAP_SHARED 로 매핑되어 수집기가 테스트 케이스마다 직접 병합합니다.
+ * 헤더는 두 벌을 번갈아 기록하고(ah_seq 가 큰 쪽이 최신), 체크섬으로 찢어진 쓰기를 걸러냅니다.
+ *
+ * 슬롯은 배치 번호(as_gen)와 함께 "이 배치 이전 값(as_prev)"을 보관합니다.
+ * 커밋된 배치(ah_generation) 이후에 갱신된 슬롯은 as_prev 를 값으로 보므로,
+ * 크래시 후 다시 열 때 테이블을 스캔하지 않고 헤더만 읽어 O(1) 로 마지막 일관 상태를 얻습니다.
+ * 정상 종료(ah_clean)가 아니었다면 끊긴 배치 번호를 ah_torn 에 기록하고 그 번호는 건너뜁니다.
+ * ah_used 는 슬롯을 차지하기 전에 ACC_USED_RESERVE 단위로 미리 올려 기록하므로 크래시 후에도
+ * 실제 점유 수보다 작아지지 않습니다. 끊긴 배치가 새로 차지한 슬롯(커밋된 값이 0 인 고아 슬롯)은
+ * 이후 다른 PC 가 재사용하고, 정규화와 정상 종료 때 ah_used 를 실제 점유 슬롯 수로 맞춥니다.
+ */
+#define ACC_MAGIC           (uint32_t)0x4B414343U   /* "CCAK" */
+#define ACC_PAGE            4096
+#define ACC_DEFAULT_SLOTS   (1u << 18)
+#define ACC_BATCH_CASES     8       /* 이 수의 테스트 케이스마다 msync + 헤더 커밋 */
+#define ACC_MAX_TORN        32
+#define ACC_USED_RESERVE(n) ((n) / 64 ? (n) / 64 : 1)   /* ah_used 를 미리 올리는 단위 */
+#define ACC_TEST_CASES      64
+
+typedef struct acc_header {
+    uint32_t ah_magic;
+    uint32_t ah_nslots;
+    uint64_t ah_seq;          /* 헤더 기록 순번 (A/B 중 최신 선택용) */
+    uint64_t ah_generation;   /* 마지막으로 커밋된 배치 번호 */
+    uint64_t ah_cases;        /* 커밋된 테스트 케이스 수 */
+    uint64_t ah_unique;       /* 커밋된 고유 PC 수 */
+    uint64_t ah_used;         /* 사용 중인 슬롯 수의 상한 (슬롯을 차지하기 전에 미리 늘려 기록) */
+    uint64_t ah_dropped;      /* 테이블이 가득 차 버린 PC 수 */
+    uint32_t ah_clean;        /* 정상 종료 여부 */
+    uint32_t ah_ntorn;
+    uint64_t ah_torn[ACC_MAX_TORN];
+    uint64_t ah_checksum;     /* 위 필드들의 FNV-1a */
+} acc_header_t;
+
+typedef struct acc_slot {
+    uint64_t as_pc;           /* 0 이면 빈 슬롯 */
+    uint64_t as_gen;          /* 마지막으로 갱신한 배치 */
+    uint64_t as_count;        /* as_gen 배치까지 반영된 히트 수 */
+    uint64_t as_prev;         /* as_gen 이전까지의 히트 수 */
+} acc_slot_t;
+
+typedef struct acc_file {
+    int           fd;
+    uint8_t      *base;
+    size_t        size;
+    acc_slot_t   *slots;
+    acc_header_t  hdr;        /* 마지막으로 기록한 헤더 */
+    uint64_t      batch;      /* 진행 중인 배치 번호 */
+    uint32_t      batch_cases;
+    uint64_t      batch_new;  /* 진행 중 배치에서 새로 값이 생긴 PC 수 */
+    uint64_t      used;       /* 실제로 차지한 슬롯 수 (hdr.ah_used 이하) */
+} acc_file_t;
+
+static uint64_t acc_checksum(const acc_header_t *h) {
+    const uint8_t *p = (const uint8_t *)h;
+    uint64_t x = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < offsetof(acc_header_t, ah_checksum); i++) {
+        x = (x ^ p[i]) * 0x100000001b3ULL;
+    }
+    return x;
+}
+
+static int acc_header_valid(const acc_header_t *h) {
+    return h->ah_magic == ACC_MAGIC && h->ah_checksum == acc_checksum(h) && h->ah_ntorn <= ACC_MAX_TORN;
+}
+
+static int acc_is_torn(const acc_header_t *h, uint64_t gen) {
+    for (uint32_t i = 0; i < h->ah_ntorn; i++) {
+        if (h->ah_torn[i] == gen) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* 커밋된 상태 기준 슬롯 값 */
+static uint64_t acc_slot_value(const acc_header_t *h, const acc_slot_t *s) {
+    if (s->as_gen <= h->ah_generation && !acc_is_torn(h, s->as_gen)) {
+        return s->as_count;
+    }
+    return s->as_prev;
+}
+
+/* 헤더를 반대쪽 페이지에 기록하고 동기화 */
+static int acc_write_header(acc_file_t *af) {
+    af->hdr.ah_seq++;
+    af->hdr.ah_checksum = acc_checksum(&af->hdr);
+    uint8_t *page = af->base + (af->hdr.ah_seq % 2) * ACC_PAGE;
+    memcpy(page, &af->hdr, sizeof(af->hdr));
+    return msync(page, ACC_PAGE, MS_SYNC) == 0 ? 0 : errno;
+}
+
+/*
+ * 끊긴 배치 목록이 가득 찼을 때만 수행하는 정규화 (O(슬롯 수)).
+ * 모든 슬롯을 커밋된 값으로 되돌리고 목록을 비우며, 사용 중인 슬롯 수를 다시 셉니다.
+ */
+static int acc_normalize(acc_file_t *af) {
+    uint64_t used = 0;
+    for (uint32_t i = 0; i < af->hdr.ah_nslots; i++) {
+        acc_slot_t *s = &af->slots[i];
+        if (s->as_pc) {
+            s->as_count = acc_slot_value(&af->hdr, s);
+            s->as_prev = s->as_count;
+            s->as_gen = 0;
+            used++;
+        }
+    }
+    af->hdr.ah_used = used;
+    af->used = used;
+    if (msync(af->slots, (size_t)af->hdr.ah_nslots * sizeof(acc_slot_t), MS_SYNC) != 0) {
+        return errno;
+    }
+    af->hdr.ah_ntorn = 0;
+    return acc_write_header(af);
+}
+
+/*
+ * 새 누적 파일을 임시 이름으로 만들어 첫 헤더까지 기록한 뒤 rename.
+ * 생성 도중 크래시해도 유효한 헤더가 없는(다시 열 수 없는) 파일이 path 에 남지 않습니다.
+ */
+static int acc_create(const char *path, uint32_t nslots) {
+    char tmp[1024];
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    int fd = open(tmp, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return errno;
+    }
+
+    acc_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.ah_magic = ACC_MAGIC;
+    h.ah_nslots = nslots;
+    h.ah_clean = 1;
+    h.ah_checksum = acc_checksum(&h);
+
+    int ret = 0;
+    errno = 0;
+    if (ftruncate(fd, (off_t)(2 * ACC_PAGE + (size_t)nslots * sizeof(acc_slot_t))) != 0 ||
+        pwrite(fd, &h, sizeof(h), 0) != (ssize_t)sizeof(h) || fsync(fd) != 0 ||
+        rename(tmp, path) != 0) {
+        ret = errno ? errno : EIO;
+        unlink(tmp);
+    }
+    close(fd);
+    return ret;
+}
+
+static int acc_open(acc_file_t *af, const char *path, uint32_t nslots) {
+    memset(af, 0, sizeof(*af));
+    af->fd = open(path, O_RDWR);
+    if (af->fd < 0 && errno == ENOENT) {
+        int ret = acc_create(path, nslots);
+        if (ret != 0) {
+            return ret;
+        }
+        af->fd = open(path, O_RDWR);
+    }
+    if (af->fd < 0) {
+        return errno;
+    }
+
+    struct stat st;
+    if (fstat(af->fd, &st) != 0) {
+        int ret = errno;
+        close(af->fd);
+        return ret;
+    }
+    if ((size_t)st.st_size < 2 * ACC_PAGE) {
+        close(af->fd);
+        return EINVAL;
+    }
+    af->size = (size_t)st.st_size;
+
+    af->base = mmap(NULL, af->size, PROT_READ | PROT_WRITE, MAP_SHARED, af->fd, 0);
+    if (af->base == MAP_FAILED) {
+        int ret = errno;
+        close(af->fd);
+        return ret;
+    }
+    af->slots = (acc_slot_t *)(af->base + 2 * ACC_PAGE);
+
+    /* 두 헤더 중 유효하고 최신인 것 선택 - 테이블은 읽지 않음 */
+    const acc_header_t *a = (const acc_header_t *)af->base;
+    const acc_header_t *b = (const acc_header_t *)(af->base + ACC_PAGE);
+    int va = acc_header_valid(a), vb = acc_header_valid(b);
+    if (!va && !vb) {
+        munmap(af->base, af->size);
+        close(af->fd);
+        return EINVAL;
+    }
+    af->hdr = (va && (!vb || a->ah_seq > b->ah_seq)) ? *a : *b;
+    if (2 * ACC_PAGE + (size_t)af->hdr.ah_nslots * sizeof(acc_slot_t) > af->size) {
+        munmap(af->base, af->size);
+        close(af->fd);
+        return EINVAL;
+    }
+
+    if (!af->hdr.ah_clean && af->hdr.ah_ntorn == ACC_MAX_TORN) {
+        int ret = acc_normalize(af);
+        if (ret != 0) {
+            munmap(af->base, af->size);
+            close(af->fd);
+            return ret;
+        }
+    }
+
+    /* 다음 배치 번호는 커밋된 배치와 이미 끊긴 배치들보다 커야 함 */
+    uint64_t next = af->hdr.ah_generation + 1;
+    for (uint32_t i = 0; i < af->hdr.ah_ntorn; i++) {
+        if (af->hdr.ah_torn[i] >= next) {
+            next = af->hdr.ah_torn[i] + 1;
+        }
+    }
+    if (!af->hdr.ah_clean) {
+        /* 직전 세션이 커밋하지 못한 배치는 버리고 그 번호는 건너뜀 */
+        af->hdr.ah_torn[af->hdr.ah_ntorn++] = next;
+        next++;
+    }
+    af->batch = next;
+    af->used = af->hdr.ah_used;
+
+    af->hdr.ah_clean = 0;
+    int ret = acc_write_header(af);
+    if (ret != 0) {
+        munmap(af->base, af->size);
+        close(af->fd);
+    }
+    return ret;
+}
+
+/*
+ * 끊긴(또는 커밋되지 않은) 배치가 차지했지만 커밋된 값이 없는 슬롯인지.
+ * 진행 중 배치에서 차지한 슬롯은 제외합니다.
+ */
+static int acc_slot_orphan(const acc_file_t *af, const acc_slot_t *s) {
+    return s->as_prev == 0 && s->as_gen != af->batch && acc_slot_value(&af->hdr, s) == 0;
+}
+
+/* PC 하나를 진행 중인 배치에 반영 */
+static void acc_add(acc_file_t *af, uint64_t pc, uint64_t hits) {
+    uint32_t mask = af->hdr.ah_nslots - 1;
+    uint32_t i = (uint32_t)((pc * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    acc_slot_t *s = NULL;
+    acc_slot_t *orphan = NULL;
+
+    /* 같은 PC 가 두 슬롯에 생기지 않도록 체인 끝(빈 슬롯)까지 찾고, 그동안 첫 고아 슬롯을 기억 */
+    for (uint32_t probe = 0; probe < af->hdr.ah_nslots; probe++, i = (i + 1) & mask) {
+        acc_slot_t *c = &af->slots[i];
+        if (c->as_pc == pc) {
+            s = c;
+            break;
+        }
+        if (c->as_pc == 0) {
+            break;
+        }
+        if (!orphan && acc_slot_orphan(af, c)) {
+            orphan = c;
+        }
+    }
+
+    if (!s) {
+        if (orphan) {
+            s = orphan;
+        } else if (af->slots[i].as_pc == 0 &&
+                   (af->used + 1) * 4 <= (uint64_t)af->hdr.ah_nslots * 3) {
+            if (af->used + 1 > af->hdr.ah_used) {
+                /* 슬롯을 차지하기 전에 상한을 먼저 기록 (크래시 후 ah_used 가 모자라지 않도록) */
+                af->hdr.ah_used = af->used + ACC_USED_RESERVE(af->hdr.ah_nslots);
+                if (acc_write_header(af) != 0) {
+                    af->hdr.ah_dropped += hits;
+                    return;
+                }
+            }
+            s = &af->slots[i];
+            af->used++;
+        } else {
+            af->hdr.ah_dropped += hits;
+            return;
+        }
+        /* 새 슬롯: 커밋 전에는 값 0 으로 보이도록 prev/gen 을 먼저 기록 */
+        s->as_prev = 0;
+        s->as_count = 0;
+        s->as_gen = af->batch;
+        atomic_thread_fence(memory_order_release);
+        s->as_pc = pc;
+    }
+
+    if (s->as_gen != af->batch) {
+        /* 이 배치에서 처음 건드리는 슬롯: 커밋된 값을 prev 로 보존한 뒤 배치 번호 갱신 */
+        uint64_t base = acc_slot_value(&af->hdr, s);
+        s->as_prev = base;
+        atomic_thread_fence(memory_order_release);
+        s->as_gen = af->batch;
+        atomic_thread_fence(memory_order_release);
+        s->as_count = base;
+    }
+    if (s->as_prev == 0 && s->as_count == 0) {
+        af->batch_new++;
+    }
+    s->as_count += hits;
+}
+
+/* 진행 중인 배치를 커밋: 슬롯 msync 후 헤더 기록 */
+static int acc_commit(acc_file_t *af) {
+    if (af->batch_cases == 0) {
+        return 0;
+    }
+    if (msync(af->slots, (size_t)af->hdr.ah_nslots * sizeof(acc_slot_t), MS_SYNC) != 0) {
+        return errno;
+    }
+    af->hdr.ah_generation = af->batch;
+    af->hdr.ah_cases += af->batch_cases;
+    af->hdr.ah_unique += af->batch_new;
+    int ret = acc_write_header(af);
+    if (ret == 0) {
+        af->batch++;
+        af->batch_cases = 0;
+        af->batch_new = 0;
+    }
+    return ret;
+}
+
+/* 테스트 케이스 하나의 TRACE 결과를 병합하고, 배치가 차면 커밋 */
+static int acc_merge_trace(acc_file_t *af, ksancov_trace_t *trace) {
+    size_t head = ksancov_trace_head(trace);
+    for (size_t i = 0; i < head; i++) {
+        acc_add(af, trace->kt_entries[i], 1);
+    }
+    af->batch_cases++;
+    return af->batch_cases >= ACC_BATCH_CASES ? acc_commit(af) : 0;
+}
+
+static int acc_close(acc_file_t *af) {
+    int ret = acc_commit(af);
+    if (ret == 0) {
+        af->hdr.ah_clean = 1;
+        af->hdr.ah_used = af->used;   /* 모든 슬롯이 커밋됐으므로 정확한 값으로 */
+        ret = acc_write_header(af);
+    }
+    munmap(af->base, af->size);
+    close(af->fd);
+    return ret;
+}
+
+/* 테스트 케이스마다 조금씩 다른 시스템 콜 실행 */
+static void run_test_case(int i) {
+    int fds[2];
+    switch (i % 4) {
+    case 0:
+        getppid();
+        break;
+    case 1:
+        if (pipe(fds) == 0) {
+            write(fds[1], &i, sizeof(i));
+            read(fds[0], &i, sizeof(i));
+            close(fds[0]);
+            close(fds[1]);
+        }
+        break;
+    case 2: {
+        int fd = open("/tmp/ksancov_acc_case.txt", O_CREAT | O_WRONLY | O_TRUNC, 0644);
+        if (fd >= 0) {
+            write(fd, &i, sizeof(i));
+            close(fd);
+            unlink("/tmp/ksancov_acc_case.txt");
+        }
+        break;
+    }
+    default: {
+        void *p = mmap(NULL, 4096 * (size_t)(1 + i % 8), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANON, -1, 0);
+        if (p != MAP_FAILED) {
+            munmap(p, 4096 * (size_t)(1 + i % 8));
+        }
+        break;
+    }
+    }
+}
+
+/* 예제 4: 자식 프로세스 커버리지를 크래시 안전 파일에 누적 */
+static int example_fork_persist_mode(const char *path, int simulate_crash) {
+    printf("\n=== FORK 누적(persist) 모드 예제 ===\n");
+    
+    // 이전 세션 상태 복구 (헤더만 읽으므로 O(1))
+    acc_file_t acc;
+    int ret = acc_open(&acc, path, ACC_DEFAULT_SLOTS);
+    if (ret != 0) {
+        printf("누적 파일 열기 실패 (%s): %s\n", path, strerror(ret));
+        return ret;
+    }
+    printf("누적 파일: %s (배치 %llu, 테스트 케이스 %llu, 고유 PC %llu, 끊긴 배치 %u개)\n", path,
+           (unsigned long long)acc.hdr.ah_generation, (unsigned long long)acc.hdr.ah_cases,
+           (unsigned long long)acc.hdr.ah_unique, acc.hdr.ah_ntorn);
+    acc_close(&acc);
+    
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open");
+        return errno;
+    }
+    
+    size_t max_entries = 5000;
+    ret = ksancov_mode_trace(fd, max_entries);
+    if (ret != 0) {
+        perror("ksancov_mode_trace");
+        close(fd);
+        return ret;
+    }
+    
+    uintptr_t buf;
+    size_t sz;
+    ret = ksancov_map(fd, &buf, &sz);
+    if (ret != 0) {
+        perror("ksancov_map");
+        close(fd);
+        return ret;
+    }
+    
+    pid_t pid = fork();
+    if (pid == 0) {
+        // 자식 프로세스: 테스트 케이스마다 누적 파일에 병합
+        ret = ksancov_thread_self(fd);
+        if (ret != 0) {
+            perror("ksancov_thread_self");
+            exit(1);
+        }
+        if (acc_open(&acc, path, ACC_DEFAULT_SLOTS) != 0) {
+            exit(1);
+        }
+        
+        ksancov_trace_t *trace = (ksancov_trace_t *)buf;
+        for (int i = 0; i < ACC_TEST_CASES; i++) {
+            atomic_store_explicit(&trace->kt_head, 0, memory_order_relaxed);
+            ksancov_start((void*)buf);
+            run_test_case(i);
+            ksancov_stop((void*)buf);
+            
+            if (acc_merge_trace(&acc, trace) != 0) {
+                perror("acc_merge_trace");
+                exit(1);
+            }
+            if (simulate_crash && i == ACC_TEST_CASES / 2 + ACC_BATCH_CASES / 2) {
+                printf("자식: 테스트 케이스 %d 에서 크래시 시뮬레이션\n", i);
+                abort();
+            }
+        }
+        
+        exit(acc_close(&acc) == 0 ? 0 : 1);
+    } else if (pid < 0) {
+        perror("fork");
+        close(fd);
+        return errno;
+    }
+    
+    int status;
+    waitpid(pid, &status, 0);
+    printf("자식 프로세스 종료 (status=%d)\n", status);
+    
+    // 자식이 죽었더라도 마지막 커밋 상태를 바로 복구
+    ret = acc_open(&acc, path, ACC_DEFAULT_SLOTS);
+    if (ret != 0) {
+        printf("누적 파일 열기 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    printf("복구된 상태: 배치 %llu, 테스트 케이스 %llu, 고유 PC %llu, 버린 PC %llu, 끊긴 배치 %u개\n",
+           (unsigned long long)acc.hdr.ah_generation, (unsigned long long)acc.hdr.ah_cases,
+           (unsigned long long)acc.hdr.ah_unique, (unsigned long long)acc.hdr.ah_dropped,
+           acc.hdr.ah_ntorn);
+    
+    printf("처음 5개 누적 PC:\n");
+    for (uint32_t i = 0, shown = 0; i < acc.hdr.ah_nslots && shown < 5; i++) {
+        uint64_t v = acc.slots[i].as_pc ? acc_slot_value(&acc.hdr, &acc.slots[i]) : 0;
+        if (v) {
+            printf("  0x%llx: %llu회\n", (unsigned long long)acc.slots[i].as_pc, (unsigned long long)v);
+            shown++;
+        }
+    }
+    acc_close(&acc);
+    
+    close(fd);
+    return 0;
+}
+
 /* 메인 함수 */
 int main(int argc, char *argv[]) {
     printf("KSANCOV 커버리지 측정 예제\n");
@@ -434,8 +925,12 @@ int main(int argc, char *argv[]) {
             return example_counters_mode();
         } else if (strcmp(argv[1], "fork") == 0) {
             return example_fork_mode();
+        } else if (strcmp(argv[1], "persist") == 0) {
+            const char *path = argc > 2 ? argv[2] : "ksancov_acc.bin";
+            int crash = argc > 3 && strcmp(argv[3], "crash") == 0;
+            return example_fork_persist_mode(path, crash);
         } else {
-            printf("사용법: %s [trace|counters|fork]\n", argv[0]);
+            printf("사용법: %s [trace|counters|fork|persist [파일] [crash]]\n", argv[0]);
             return 1;
         }
     }
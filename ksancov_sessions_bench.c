@@ -0,0 +1,636 @@
+/*
+ * 동시 수집 세션 벤치마크
+ *
+ * 여러 ksancov 세션(TRACE 모드)을 동시에 돌리면서 worker / drainer / analyzer 스레드를
+ * 지정한 코어에 고정하고, 캐시 라인 경합을 줄였을 때의 처리량 차이를 측정합니다.
+ *
+ * ksancov_header_t 는 kh_magic 옆에 _Atomic kh_enabled 를 두고, TRACE 모드에서는 kt_head 까지
+ * 같은 캐시 라인에 있습니다. 이 레이아웃은 커널 ABI 이므로 바꿀 수 없습니다. 대신:
+ *   - naive    : drainer 가 커널 헤더의 kt_head 를 직접 스핀 폴링하고,
+ *                세션 상태/통계를 패딩 없이 한 배열에 둡니다. (기존 방식)
+ *   - isolated : worker 가 윈도우(start ~ stop)를 마칠 때마다 자기 캐시 라인에 head 와
+ *                시퀀스를 게시하고, drainer 는 그 라인만 적응형 백오프로 폴링합니다.
+ *                커널 헤더 라인은 윈도우당 한 번만 읽으며, 사용자 측 상태는 모두
+ *                캐시 라인 단위로 패딩됩니다.
+ *
+ * 코어 고정은 macOS 에서는 THREAD_AFFINITY_POLICY (힌트, Apple Silicon 에서는 미지원일 수 있음),
+ * Linux 에서는 pthread_setaffinity_np 를 사용합니다.
+ *
+ * 컴파일: gcc -O2 -o ksancov_sessions_bench ksancov_sessions_bench.c -lpthread
+ * 실행:
+ *   sudo ./ksancov_sessions_bench [-n 최대세션수] [-t 초] [-m naive|isolated|both]
+ *                                 [-w worker코어목록] [-r drainer코어목록] [-a analyzer코어목록]
+ *   예) sudo ./ksancov_sessions_bench -n 4 -w 0,1,2,3 -r 4,5,6,7 -a 8
+ */
+
+#if defined(__linux__)
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/thread_policy.h>
+#endif
+
+/* ksancov 헤더 파일에서 필요한 정의들 */
+#define KSANCOV_PATH "/dev/ksancov"
+
+/* ioctl 명령어들 */
+#define KSANCOV_IOC_TRACE        _IOW('K', 1, size_t)
+#define KSANCOV_IOC_MAP          _IOWR('K', 8, struct ksancov_buf_desc)
+#define KSANCOV_IOC_START        _IOW('K', 10, uintptr_t)
+
+/* 매직 넘버들 */
+#define KSANCOV_TRACE_MAGIC     (uint32_t)0x5AD17F5BU
+
+/* 버퍼 설명자 */
+struct ksancov_buf_desc {
+    uintptr_t ptr;
+    size_t sz;
+};
+
+/* 공통 헤더 */
+typedef struct ksancov_header {
+    uint32_t         kh_magic;
+    _Atomic uint32_t kh_enabled;
+} ksancov_header_t;
+
+/* TRACE 모드 구조체 */
+typedef struct ksancov_trace {
+    ksancov_header_t kt_hdr;
+    uint32_t         kt_maxent;
+    _Atomic uint32_t kt_head;
+    uint64_t         kt_entries[];
+} ksancov_trace_t;
+
+/* 벤치마크 설정 */
+#define CACHE_LINE              128     /* Apple Silicon 기준 (x86_64 는 64) */
+#define BENCH_MAX_SESSIONS      32
+#define BENCH_MAX_CORES         64
+#define BENCH_TRACE_ENTRIES     (16 * 1024)
+#define BENCH_SYSCALLS_PER_WIN  64      /* 윈도우 하나에서 실행할 시스템 콜 수 */
+
+#define BACKOFF_SPIN_LIMIT      64      /* 이 횟수까지는 cpu_relax 스핀 */
+#define BACKOFF_YIELD_LIMIT     128     /* 그 다음은 sched_yield */
+#define BACKOFF_MAX_SLEEP_NS    50000   /* 이후 nanosleep, 최대 50us */
+
+typedef enum {
+    BENCH_NAIVE,
+    BENCH_ISOLATED,
+} bench_mode_t;
+
+/* isolated 모드: 쓰는 쪽이 다른 필드들을 서로 다른 캐시 라인에 배치 */
+typedef struct session_isolated {
+    /* worker 가 쓰고 drainer 가 읽음 */
+    alignas(CACHE_LINE) _Atomic uint64_t published_seq;
+    uint32_t         published_head;
+    /* drainer 가 쓰고 worker 가 읽음 */
+    alignas(CACHE_LINE) _Atomic uint64_t consumed_seq;
+    /* worker 전용 */
+    alignas(CACHE_LINE) uint64_t windows;
+    uint64_t         syscalls;
+    /* drainer 전용 (analyzer 가 가끔 읽음) */
+    alignas(CACHE_LINE) _Atomic uint64_t drained_entries;
+    uint64_t         polls;
+    uint64_t         pc_xor;
+} session_isolated_t;
+
+/* naive 모드: 모든 필드가 붙어 있고 세션끼리도 인접 */
+typedef struct session_naive {
+    _Atomic uint64_t published_seq;
+    _Atomic uint64_t consumed_seq;
+    _Atomic uint64_t windows;
+    _Atomic uint64_t syscalls;
+    _Atomic uint64_t drained_entries;
+    _Atomic uint64_t polls;
+    uint64_t         pc_xor;
+} session_naive_t;
+
+/* 세션 하나 */
+typedef struct session {
+    int              fd;
+    ksancov_trace_t *trace;
+    int              worker_core;
+    int              drainer_core;
+} session_t;
+
+/* 코어 목록 */
+typedef struct core_list {
+    int    cores[BENCH_MAX_CORES];
+    size_t count;
+} core_list_t;
+
+/* 벤치마크 한 회 실행 상태 */
+typedef struct bench {
+    bench_mode_t        mode;
+    size_t              nsessions;
+    session_t          *sessions;
+    session_isolated_t *iso;      /* isolated 모드 상태 */
+    session_naive_t    *naive;    /* naive 모드 상태 */
+    int                 analyzer_core;
+    _Atomic int         running;
+    alignas(CACHE_LINE) _Atomic uint64_t analyzer_total;
+} bench_t;
+
+typedef struct thread_arg {
+    bench_t *bench;
+    size_t   idx;
+} thread_arg_t;
+
+/* 헬퍼 함수들 */
+static int ksancov_open(void) {
+    return open(KSANCOV_PATH, O_RDWR);
+}
+
+static int ksancov_map(int fd, uintptr_t *buf, size_t *sz) {
+    struct ksancov_buf_desc mc = {0};
+    int ret = ioctl(fd, KSANCOV_IOC_MAP, &mc);
+    if (ret == -1) {
+        return errno;
+    }
+    *buf = mc.ptr;
+    if (sz) {
+        *sz = mc.sz;
+    }
+    return 0;
+}
+
+static int ksancov_mode_trace(int fd, size_t entries) {
+    int ret = ioctl(fd, KSANCOV_IOC_TRACE, &entries);
+    return (ret == -1) ? errno : 0;
+}
+
+static int ksancov_thread_self(int fd) {
+    uintptr_t th = 0;
+    int ret = ioctl(fd, KSANCOV_IOC_START, &th);
+    return (ret == -1) ? errno : 0;
+}
+
+static void ksancov_start(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 1, memory_order_relaxed);
+}
+
+static void ksancov_stop(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 0, memory_order_relaxed);
+}
+
+static void ksancov_reset_trace(ksancov_trace_t *trace) {
+    atomic_store_explicit(&trace->kt_head, 0, memory_order_relaxed);
+}
+
+static uint32_t ksancov_trace_head(ksancov_trace_t *trace) {
+    uint32_t head = atomic_load_explicit(&trace->kt_head, memory_order_acquire);
+    return head < trace->kt_maxent ? head : trace->kt_maxent;
+}
+
+/* ---- 코어 고정 / 백오프 ---- */
+
+static inline void cpu_relax(void) {
+#if defined(__aarch64__)
+    __asm__ volatile("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+    __asm__ volatile("pause");
+#endif
+}
+
+/* 현재 스레드를 core 에 고정 (core < 0 이면 아무것도 하지 않음) */
+static void pin_current_thread(int core) {
+    static _Atomic int warned;
+    if (core < 0) {
+        return;
+    }
+#if defined(__APPLE__)
+    thread_affinity_policy_data_t policy = { core + 1 };
+    kern_return_t kr = thread_policy_set(pthread_mach_thread_np(pthread_self()),
+                                         THREAD_AFFINITY_POLICY,
+                                         (thread_policy_t)&policy,
+                                         THREAD_AFFINITY_POLICY_COUNT);
+    if (kr != KERN_SUCCESS && !atomic_exchange(&warned, 1)) {
+        printf("경고: THREAD_AFFINITY_POLICY 미지원 (kr=%d) - 코어 고정 없이 진행합니다.\n", kr);
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0 && !atomic_exchange(&warned, 1)) {
+        printf("경고: 코어 %d 고정 실패 - 코어 고정 없이 진행합니다.\n", core);
+    }
+#else
+    (void)warned;
+#endif
+}
+
+/* 적응형 백오프: 짧게 스핀 -> yield -> 점점 길어지는 sleep */
+typedef struct backoff {
+    uint32_t round;
+    uint32_t sleep_ns;
+} backoff_t;
+
+static void backoff_reset(backoff_t *b) {
+    b->round = 0;
+    b->sleep_ns = 1000;
+}
+
+static void backoff_wait(backoff_t *b) {
+    if (b->round < BACKOFF_SPIN_LIMIT) {
+        cpu_relax();
+    } else if (b->round < BACKOFF_YIELD_LIMIT) {
+        sched_yield();
+    } else {
+        struct timespec ts = { 0, (long)b->sleep_ns };
+        nanosleep(&ts, NULL);
+        if (b->sleep_ns < BACKOFF_MAX_SLEEP_NS) {
+            b->sleep_ns *= 2;
+        }
+    }
+    b->round++;
+}
+
+static int parse_core_list(const char *s, core_list_t *out) {
+    out->count = 0;
+    while (*s && out->count < BENCH_MAX_CORES) {
+        char *end;
+        long v = strtol(s, &end, 10);
+        if (end == s || v < 0) {
+            return EINVAL;
+        }
+        out->cores[out->count++] = (int)v;
+        s = (*end == ',') ? end + 1 : end;
+    }
+    return 0;
+}
+
+static int core_at(const core_list_t *l, size_t i) {
+    return l->count ? l->cores[i % l->count] : -1;
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- 스레드 본체 ---- */
+
+/* 측정 대상 작업: 윈도우 하나 동안 가벼운 시스템 콜 반복 */
+static void run_window_workload(void) {
+    for (int i = 0; i < BENCH_SYSCALLS_PER_WIN; i++) {
+        getppid();
+    }
+}
+
+static void *worker_thread(void *p) {
+    thread_arg_t *arg = p;
+    bench_t *b = arg->bench;
+    session_t *s = &b->sessions[arg->idx];
+    backoff_t bo;
+
+    pin_current_thread(s->worker_core);
+    if (ksancov_thread_self(s->fd) != 0) {
+        perror("ksancov_thread_self");
+        return NULL;
+    }
+
+    uint64_t seq = 0;
+    while (atomic_load_explicit(&b->running, memory_order_relaxed)) {
+        ksancov_reset_trace(s->trace);
+        ksancov_start(s->trace);
+        run_window_workload();
+        ksancov_stop(s->trace);
+        seq++;
+
+        if (b->mode == BENCH_ISOLATED) {
+            session_isolated_t *st = &b->iso[arg->idx];
+            st->published_head = ksancov_trace_head(s->trace);
+            atomic_store_explicit(&st->published_seq, seq, memory_order_release);
+            st->windows++;
+            st->syscalls += BENCH_SYSCALLS_PER_WIN;
+
+            /* drainer 가 엔트리를 읽을 때까지 대기 (리셋 전에) */
+            backoff_reset(&bo);
+            while (atomic_load_explicit(&st->consumed_seq, memory_order_acquire) != seq &&
+                   atomic_load_explicit(&b->running, memory_order_relaxed)) {
+                backoff_wait(&bo);
+            }
+        } else {
+            session_naive_t *st = &b->naive[arg->idx];
+            atomic_store_explicit(&st->published_seq, seq, memory_order_release);
+            atomic_fetch_add_explicit(&st->windows, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&st->syscalls, BENCH_SYSCALLS_PER_WIN, memory_order_relaxed);
+
+            while (atomic_load_explicit(&st->consumed_seq, memory_order_acquire) != seq &&
+                   atomic_load_explicit(&b->running, memory_order_relaxed)) {
+                /* 기존 방식: 바쁜 대기 */
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *drainer_thread(void *p) {
+    thread_arg_t *arg = p;
+    bench_t *b = arg->bench;
+    session_t *s = &b->sessions[arg->idx];
+    backoff_t bo;
+
+    pin_current_thread(s->drainer_core);
+
+    uint64_t seen = 0;
+    while (atomic_load_explicit(&b->running, memory_order_relaxed)) {
+        if (b->mode == BENCH_ISOLATED) {
+            session_isolated_t *st = &b->iso[arg->idx];
+            uint64_t seq;
+            backoff_reset(&bo);
+            while ((seq = atomic_load_explicit(&st->published_seq, memory_order_acquire)) == seen) {
+                st->polls++;
+                if (!atomic_load_explicit(&b->running, memory_order_relaxed)) {
+                    return NULL;
+                }
+                backoff_wait(&bo);
+            }
+            uint32_t head = st->published_head;
+            uint64_t x = 0;
+            for (uint32_t i = 0; i < head; i++) {
+                x ^= s->trace->kt_entries[i];
+            }
+            st->pc_xor ^= x;
+            atomic_store_explicit(&st->drained_entries,
+                                  atomic_load_explicit(&st->drained_entries, memory_order_relaxed) + head,
+                                  memory_order_relaxed);
+            seen = seq;
+            atomic_store_explicit(&st->consumed_seq, seq, memory_order_release);
+        } else {
+            session_naive_t *st = &b->naive[arg->idx];
+            uint64_t seq;
+            /* 기존 방식: 커널 헤더 라인의 kt_head 와 게시 시퀀스를 쉬지 않고 폴링 */
+            while ((seq = atomic_load_explicit(&st->published_seq, memory_order_acquire)) == seen) {
+                (void)atomic_load_explicit(&s->trace->kt_head, memory_order_acquire);
+                atomic_fetch_add_explicit(&st->polls, 1, memory_order_relaxed);
+                if (!atomic_load_explicit(&b->running, memory_order_relaxed)) {
+                    return NULL;
+                }
+            }
+            uint32_t head = ksancov_trace_head(s->trace);
+            uint64_t x = 0;
+            for (uint32_t i = 0; i < head; i++) {
+                x ^= s->trace->kt_entries[i];
+            }
+            st->pc_xor ^= x;
+            atomic_fetch_add_explicit(&st->drained_entries, head, memory_order_relaxed);
+            seen = seq;
+            atomic_store_explicit(&st->consumed_seq, seq, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+/* analyzer: 주기적으로 세션별 드레인 결과를 합산 */
+static void *analyzer_thread(void *p) {
+    bench_t *b = p;
+    pin_current_thread(b->analyzer_core);
+
+    while (atomic_load_explicit(&b->running, memory_order_relaxed)) {
+        uint64_t total = 0;
+        for (size_t i = 0; i < b->nsessions; i++) {
+            total += b->mode == BENCH_ISOLATED
+                   ? atomic_load_explicit(&b->iso[i].drained_entries, memory_order_relaxed)
+                   : atomic_load_explicit(&b->naive[i].drained_entries, memory_order_relaxed);
+        }
+        atomic_store_explicit(&b->analyzer_total, total, memory_order_relaxed);
+        struct timespec ts = { 0, 10 * 1000 * 1000 };
+        nanosleep(&ts, NULL);
+    }
+    return NULL;
+}
+
+/* ---- 벤치마크 ---- */
+
+static int session_open(session_t *s) {
+    s->fd = ksancov_open();
+    if (s->fd < 0) {
+        return errno;
+    }
+    int ret = ksancov_mode_trace(s->fd, BENCH_TRACE_ENTRIES);
+    if (ret == 0) {
+        uintptr_t buf = 0;
+        ret = ksancov_map(s->fd, &buf, NULL);
+        s->trace = (ksancov_trace_t *)buf;
+    }
+    if (ret != 0) {
+        close(s->fd);
+        s->fd = -1;
+    }
+    return ret;
+}
+
+static int run_bench(bench_mode_t mode, size_t nsessions, unsigned seconds,
+                     const core_list_t *wcores, const core_list_t *dcores, const core_list_t *acores) {
+    bench_t b;
+    memset(&b, 0, sizeof(b));
+    b.mode = mode;
+    b.nsessions = nsessions;
+    b.analyzer_core = core_at(acores, 0);
+    b.sessions = calloc(nsessions, sizeof(session_t));
+    b.iso = aligned_alloc(CACHE_LINE, nsessions * sizeof(session_isolated_t));
+    b.naive = calloc(nsessions, sizeof(session_naive_t));
+    pthread_t *workers = calloc(nsessions, sizeof(pthread_t));
+    pthread_t *drainers = calloc(nsessions, sizeof(pthread_t));
+    thread_arg_t *args = calloc(nsessions, sizeof(thread_arg_t));
+    int ret = 0;
+
+    if (!b.sessions || !b.iso || !b.naive || !workers || !drainers || !args) {
+        ret = ENOMEM;
+        goto out;
+    }
+    memset(b.iso, 0, nsessions * sizeof(session_isolated_t));
+
+    size_t opened = 0;
+    for (; opened < nsessions; opened++) {
+        b.sessions[opened].worker_core = core_at(wcores, opened);
+        b.sessions[opened].drainer_core = core_at(dcores, opened);
+        ret = session_open(&b.sessions[opened]);
+        if (ret != 0) {
+            printf("세션 %zu 열기 실패: %s\n", opened, strerror(ret));
+            break;
+        }
+    }
+    if (ret != 0) {
+        for (size_t i = 0; i < opened; i++) {
+            close(b.sessions[i].fd);
+        }
+        goto out;
+    }
+
+    atomic_store(&b.running, 1);
+    pthread_t analyzer;
+    size_t ndrainers = 0, nworkers = 0;
+    ret = pthread_create(&analyzer, NULL, analyzer_thread, &b);
+    if (ret != 0) {
+        printf("analyzer 스레드 생성 실패: %s\n", strerror(ret));
+        for (size_t i = 0; i < nsessions; i++) {
+            close(b.sessions[i].fd);
+        }
+        goto out;
+    }
+    for (size_t i = 0; i < nsessions; i++) {
+        args[i] = (thread_arg_t){ &b, i };
+        ret = pthread_create(&drainers[i], NULL, drainer_thread, &args[i]);
+        if (ret != 0) {
+            printf("세션 %zu drainer 스레드 생성 실패: %s\n", i, strerror(ret));
+            break;
+        }
+        ndrainers++;
+        ret = pthread_create(&workers[i], NULL, worker_thread, &args[i]);
+        if (ret != 0) {
+            printf("세션 %zu worker 스레드 생성 실패: %s\n", i, strerror(ret));
+            break;
+        }
+        nworkers++;
+    }
+
+    // 생성에 실패했으면 바로 멈추고, 만들어진 스레드만 join
+    uint64_t t0 = now_ns();
+    if (ret == 0) {
+        sleep(seconds);
+    }
+    atomic_store(&b.running, 0);
+    for (size_t i = 0; i < nworkers; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    for (size_t i = 0; i < ndrainers; i++) {
+        pthread_join(drainers[i], NULL);
+    }
+    pthread_join(analyzer, NULL);
+    double elapsed = (double)(now_ns() - t0) / 1e9;
+    if (ret != 0) {
+        for (size_t i = 0; i < nsessions; i++) {
+            close(b.sessions[i].fd);
+        }
+        goto out;
+    }
+
+    uint64_t windows = 0, syscalls = 0, polls = 0, entries = 0;
+    for (size_t i = 0; i < nsessions; i++) {
+        if (mode == BENCH_ISOLATED) {
+            windows += b.iso[i].windows;
+            syscalls += b.iso[i].syscalls;
+            polls += b.iso[i].polls;
+            entries += b.iso[i].drained_entries;
+        } else {
+            windows += b.naive[i].windows;
+            syscalls += b.naive[i].syscalls;
+            polls += b.naive[i].polls;
+            entries += b.naive[i].drained_entries;
+        }
+        close(b.sessions[i].fd);
+    }
+
+    printf("  %-8s 세션 %2zu: 윈도우 %10.0f/s, 시스템 콜 %12.0f/s, PC %12.0f/s, 폴링/윈도우 %8.1f\n",
+           mode == BENCH_ISOLATED ? "isolated" : "naive", nsessions,
+           windows / elapsed, syscalls / elapsed, entries / elapsed,
+           windows ? (double)polls / (double)windows : 0.0);
+
+out:
+    free(args);
+    free(drainers);
+    free(workers);
+    free(b.naive);
+    free(b.iso);
+    free(b.sessions);
+    return ret;
+}
+
+static void usage(const char *prog) {
+    printf("사용법: %s [-n 최대세션수] [-t 초] [-m naive|isolated|both]\n", prog);
+    printf("          [-w worker코어목록] [-r drainer코어목록] [-a analyzer코어목록]\n");
+    printf("  코어 목록 예: 0,2,4,6 (세션 순서대로 순환 배정)\n");
+}
+
+/* 메인 함수 */
+int main(int argc, char *argv[]) {
+    size_t max_sessions = 4;
+    unsigned seconds = 3;
+    int run_naive = 1, run_isolated = 1;
+    core_list_t wcores = {0}, dcores = {0}, acores = {0};
+
+    printf("KSANCOV 동시 세션 경합 벤치마크\n");
+    printf("================================\n");
+
+    for (int i = 1; i < argc; i++) {
+        const char *opt = argv[i];
+        const char *val = i + 1 < argc ? argv[i + 1] : NULL;
+        int ret = 0;
+        if (!val) {
+            usage(argv[0]);
+            return 1;
+        }
+        if (strcmp(opt, "-n") == 0) {
+            max_sessions = strtoul(val, NULL, 10);
+        } else if (strcmp(opt, "-t") == 0) {
+            seconds = (unsigned)strtoul(val, NULL, 10);
+        } else if (strcmp(opt, "-m") == 0) {
+            run_naive = strcmp(val, "isolated") != 0;
+            run_isolated = strcmp(val, "naive") != 0;
+        } else if (strcmp(opt, "-w") == 0) {
+            ret = parse_core_list(val, &wcores);
+        } else if (strcmp(opt, "-r") == 0) {
+            ret = parse_core_list(val, &dcores);
+        } else if (strcmp(opt, "-a") == 0) {
+            ret = parse_core_list(val, &acores);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+        if (ret != 0) {
+            printf("잘못된 코어 목록: %s\n", val);
+            return 1;
+        }
+        i++;
+    }
+    if (max_sessions == 0 || max_sessions > BENCH_MAX_SESSIONS || seconds == 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (access(KSANCOV_PATH, F_OK) != 0) {
+        printf("오류: %s 디바이스를 찾을 수 없습니다.\n", KSANCOV_PATH);
+        return 1;
+    }
+
+    printf("세션 1~%zu, 실행당 %u초, 윈도우당 시스템 콜 %d회\n\n",
+           max_sessions, seconds, BENCH_SYSCALLS_PER_WIN);
+
+    for (size_t n = 1; n <= max_sessions; n++) {
+        if (run_naive) {
+            int ret = run_bench(BENCH_NAIVE, n, seconds, &wcores, &dcores, &acores);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+        if (run_isolated) {
+            int ret = run_bench(BENCH_ISOLATED, n, seconds, &wcores, &dcores, &acores);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+    }
+
+    printf("\n벤치마크 완료!\n");
+    return 0;
+}
@@ -175,6 +175,51 @@ if [ -f "ksancov_example.c" ]; then
     fi
 fi
 
+# coverage_store 컴파일
+if [ -f "coverage_store.c" ]; then
+    if gcc -O2 -o coverage_store coverage_store.c; then
+        log_success "coverage_store 컴파일 성공"
+    else
+        log_warning "coverage_store 컴파일 실패"
+    fi
+fi
+
+# ksancov_sessions_bench 컴파일
+if [ -f "ksancov_sessions_bench.c" ]; then
+    if gcc -O2 -o ksancov_sessions_bench ksancov_sessions_bench.c -lpthread; then
+        log_success "ksancov_sessions_bench 컴파일 성공"
+    else
+        log_warning "ksancov_sessions_bench 컴파일 실패"
+    fi
+fi
+
+# syscall_scheduler 컴파일
+if [ -f "syscall_scheduler.c" ]; then
+    if gcc -O2 -o syscall_scheduler syscall_scheduler.c; then
+        log_success "syscall_scheduler 컴파일 성공"
+    else
+        log_warning "syscall_scheduler 컴파일 실패"
+    fi
+fi
+
+# edgemap_index 컴파일
+if [ -f "edgemap_index.c" ]; then
+    if gcc -O2 -o edgemap_index edgemap_index.c; then
+        log_success "edgemap_index 컴파일 성공"
+    else
+        log_warning "edgemap_index 컴파일 실패"
+    fi
+fi
+
+# trace_hotpaths 컴파일
+if [ -f "trace_hotpaths.c" ]; then
+    if gcc -O2 -o trace_hotpaths trace_hotpaths.c; then
+        log_success "trace_hotpaths 컴파일 성공"
+    else
+        log_warning "trace_hotpaths 컴파일 실패"
+    fi
+fi
+
 # 6. 권한 설정
 echo
 log_info "6. 권한 설정 중..."
@@ -183,6 +228,11 @@ log_info "6. 권한 설정 중..."
 chmod +x ksancov 2>/dev/null || true
 chmod +x simple_coverage_test 2>/dev/null || true
 chmod +x ksancov_example 2>/dev/null || true
+chmod +x coverage_store 2>/dev/null || true
+chmod +x ksancov_sessions_bench 2>/dev/null || true
+chmod +x syscall_scheduler 2>/dev/null || true
+chmod +x edgemap_index 2>/dev/null || true
+chmod +x trace_hotpaths 2>/dev/null || true
 chmod +x coverage_analyzer.py 2>/dev/null || true
 chmod +x build_and_run.sh 2>/dev/null || true
 
@@ -201,6 +251,11 @@ log_info "사용 가능한 도구들:"
 echo "  • ./ksancov - 커버리지 측정 도구"
 echo "  • ./simple_coverage_test - 간단한 커버리지 테스트"
 echo "  • ./ksancov_example - 고급 예제 프로그램"
+echo "  • ./coverage_store - 압축 커버리지 저장소"
+echo "  • ./ksancov_sessions_bench - 동시 세션 경합 벤치마크"
+echo "  • ./syscall_scheduler - 커버리지 기반 시스템 콜 스케줄러"
+echo "  • ./edgemap_index - TRACE PC -> 엣지 인덱스 변환기"
+echo "  • ./trace_hotpaths - TRACE 핫 패스(PC n-gram) 분석기"
 echo "  • ./coverage_analyzer.py - 커버리지 분석기"
 echo "  • ./run_demo.sh - 통합 데모 실행"
 
@@ -13,6 +13,7 @@
 #include <fcntl.h>
 #include <sys/ioctl.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
 
 // ksancov 헤더 파일의 내용을 포함
 #include <stdint.h>
@@ -20,6 +21,16 @@
 #include <sys/ioccom.h>
 #include <strings.h>
 #include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdalign.h>
+#include <time.h>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #define KSANCOV_PATH "/dev/ksancov"
 
@@ -122,6 +133,362 @@ static void ksancov_reset_counters(ksancov_counters_t *counters) {
     bzero(counters->kc_hits, counters->kc_nedges);
 }
 
+/* COUNTERS 하베스트 설정 */
+#define HARVEST_MIN_INTERVAL_US  100      /* 최소 수집 주기 */
+#define HARVEST_MAX_INTERVAL_US  100000   /* 최대 수집 주기 */
+#define HARVEST_HIGH_WATER       128      /* 최대 카운터가 이 이상이면 주기를 절반으로 */
+#define HARVEST_LOW_WATER        16       /* 최대 카운터가 이 미만이면 주기를 두 배로 */
+#define HARVEST_TOPK             10
+#define HARVEST_HOT_ITERATIONS   20000    /* 핫 패스를 만들기 위한 반복 시스템 콜 수 */
+
+/* 하베스트 상태 (측정 스레드 전용) */
+typedef struct harvest_state {
+    ksancov_counters_t *counters;
+    uint64_t           *shadow;        /* kc_hits 를 누적하는 64비트 섀도 배열 */
+    uint64_t            last_ns;       /* 마지막 폴딩 시각 */
+    uint32_t            interval_us;
+    uint64_t            rounds;
+    uint64_t            saturated;     /* 수집 시점에 이미 255였던 카운터 수 (손실 가능) */
+} harvest_state_t;
+
+/* 탑-K 힙 엔트리 */
+typedef struct harvest_top {
+    uint64_t hits;
+    uint32_t idx;
+} harvest_top_t;
+
+/*
+ * kc_hits 의 8비트 카운터를 64비트 섀도 배열로 폴딩하고 0으로 되돌립니다.
+ * 16바이트 단위로 읽어 모두 0이면 건너뛰고, 아니면 SIMD 확장 덧셈(u8 -> u64)으로
+ * 섀도에 더한 뒤 블록을 비웁니다.
+ * 커널은 kc_hits 를 원자적이지 않은 포화 ++ 로 올리므로, 다른 스레드에서 측정 중에
+ * 차감하면 커널의 read-modify-write 가 차감을 덮어써 같은 히트를 두 번 셀 수 있습니다.
+ * 따라서 반드시 측정 스레드에서 ksancov_stop() 한 상태로 호출해야 합니다.
+ * 관측된 최대 카운터 값을 반환합니다.
+ */
+static uint32_t harvest_fold(harvest_state_t *hs) {
+    uint8_t *hits = hs->counters->kc_hits;
+    uint64_t *shadow = hs->shadow;
+    uint32_t n = hs->counters->kc_nedges;
+    uint32_t max_seen = 0;
+
+    uint32_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8_t snap[16];
+#if defined(__ARM_NEON)
+        uint8x16_t v = vld1q_u8(hits + i);
+        if (vmaxvq_u8(v) == 0) {
+            continue;
+        }
+        vst1q_u8(snap, v);
+        uint16x8_t lo16 = vmovl_u8(vget_low_u8(v));
+        uint16x8_t hi16 = vmovl_u8(vget_high_u8(v));
+        uint32x4_t q[4] = {
+            vmovl_u16(vget_low_u16(lo16)), vmovl_u16(vget_high_u16(lo16)),
+            vmovl_u16(vget_low_u16(hi16)), vmovl_u16(vget_high_u16(hi16)),
+        };
+        for (int k = 0; k < 4; k++) {
+            uint64_t *dst = shadow + i + k * 4;
+            vst1q_u64(dst, vaddw_u32(vld1q_u64(dst), vget_low_u32(q[k])));
+            vst1q_u64(dst + 2, vaddw_u32(vld1q_u64(dst + 2), vget_high_u32(q[k])));
+        }
+#elif defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        __m128i v = _mm_loadu_si128((const __m128i *)(hits + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) == 0xffff) {
+            continue;
+        }
+        _mm_storeu_si128((__m128i *)snap, v);
+        __m128i w16[2] = { _mm_unpacklo_epi8(v, zero), _mm_unpackhi_epi8(v, zero) };
+        for (int h = 0; h < 2; h++) {
+            __m128i w32[2] = { _mm_unpacklo_epi16(w16[h], zero), _mm_unpackhi_epi16(w16[h], zero) };
+            for (int k = 0; k < 2; k++) {
+                __m128i w64[2] = { _mm_unpacklo_epi32(w32[k], zero), _mm_unpackhi_epi32(w32[k], zero) };
+                for (int m = 0; m < 2; m++) {
+                    __m128i *dst = (__m128i *)(shadow + i + h * 8 + k * 4 + m * 2);
+                    _mm_storeu_si128(dst, _mm_add_epi64(_mm_loadu_si128(dst), w64[m]));
+                }
+            }
+        }
+#else
+        uint64_t a, b;
+        memcpy(snap, hits + i, sizeof(snap));
+        memcpy(&a, snap, 8);
+        memcpy(&b, snap + 8, 8);
+        if ((a | b) == 0) {
+            continue;
+        }
+        for (int k = 0; k < 16; k++) {
+            shadow[i + k] += snap[k];
+        }
+#endif
+        memset(hits + i, 0, 16);
+        for (int k = 0; k < 16; k++) {
+            if (snap[k] > max_seen) {
+                max_seen = snap[k];
+            }
+            if (snap[k] == UINT8_MAX) {
+                hs->saturated++;
+            }
+        }
+    }
+    for (; i < n; i++) {
+        uint8_t h = hits[i];
+        if (h == 0) {
+            continue;
+        }
+        shadow[i] += h;
+        hits[i] = 0;
+        if (h > max_seen) {
+            max_seen = h;
+        }
+        if (h == UINT8_MAX) {
+            hs->saturated++;
+        }
+    }
+
+    hs->rounds++;
+    return max_seen;
+}
+
+/* 관측된 최대 카운터에 맞춰 주기를 절반/두 배로 조절 (최소/최대 주기로 제한) */
+static void harvest_adapt(harvest_state_t *hs, uint32_t max_seen) {
+    if (max_seen >= HARVEST_HIGH_WATER) {
+        hs->interval_us /= 2;
+        if (hs->interval_us < HARVEST_MIN_INTERVAL_US) {
+            hs->interval_us = HARVEST_MIN_INTERVAL_US;
+        }
+    } else if (max_seen < HARVEST_LOW_WATER) {
+        hs->interval_us *= 2;
+        if (hs->interval_us > HARVEST_MAX_INTERVAL_US) {
+            hs->interval_us = HARVEST_MAX_INTERVAL_US;
+        }
+    }
+}
+
+static void harvest_top_sift_down(harvest_top_t *heap, size_t n, size_t i) {
+    for (;;) {
+        size_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < n && heap[l].hits < heap[m].hits) m = l;
+        if (r < n && heap[r].hits < heap[m].hits) m = r;
+        if (m == i) return;
+        harvest_top_t t = heap[i];
+        heap[i] = heap[m];
+        heap[m] = t;
+        i = m;
+    }
+}
+
+static int harvest_top_cmp(const void *a, const void *b) {
+    const harvest_top_t *x = a, *y = b;
+    return (x->hits < y->hits) - (x->hits > y->hits);
+}
+
+/* TRACE 파이프라인 설정 */
+#define PIPE_CACHE_LINE      128
+#define PIPE_BATCH_ENTRIES   4096     /* 배치 하나에 담는 PC 수 */
+#define PIPE_POOL_SIZE       32       /* 풀에 미리 만들어 두는 배치 버퍼 수 */
+#define PIPE_RING_SIZE       64       /* 링 슬롯 수 (2의 거듭제곱, 풀 크기 이상) */
+#define PIPE_WINDOWS         16       /* 측정 윈도우 수 */
+#define PIPE_DEDUP_INIT      (1u << 16)
+
+/* 배치 버퍼 (풀에서 재사용) */
+typedef struct trace_batch {
+    uint32_t window;
+    uint32_t count;
+    int      last;                    /* 종료 표시 배치 */
+    uint64_t pcs[PIPE_BATCH_ENTRIES];
+} trace_batch_t;
+
+/*
+ * 단일 생산자/단일 소비자 링.
+ * head 는 소비자만, tail 은 생산자만 쓰며, 각자 상대 인덱스의 캐시 사본을 자기 라인에 둡니다.
+ */
+typedef struct spsc_ring {
+    alignas(PIPE_CACHE_LINE) _Atomic size_t head;
+    size_t cached_tail;
+    alignas(PIPE_CACHE_LINE) _Atomic size_t tail;
+    size_t cached_head;
+    alignas(PIPE_CACHE_LINE) trace_batch_t *slots[PIPE_RING_SIZE];
+} spsc_ring_t;
+
+/* 파이프라인 전체 상태 */
+typedef struct trace_pipeline {
+    spsc_ring_t  to_dedup;            /* collector -> dedup */
+    spsc_ring_t  to_export;           /* dedup -> export */
+    spsc_ring_t  free_pool;           /* export -> collector (버퍼 반환) */
+    FILE        *out;                 /* export 대상 (NULL 이면 집계만) */
+    /* dedup 스테이지 전용 */
+    alignas(PIPE_CACHE_LINE) uint64_t *set;
+    size_t       set_cap;
+    size_t       set_count;
+    uint64_t     dedup_batches;
+    /* export 스테이지 전용 */
+    alignas(PIPE_CACHE_LINE) uint64_t exported;
+    uint64_t     export_batches;
+    /* collector 전용 */
+    alignas(PIPE_CACHE_LINE) uint64_t stalls;   /* 백프레셔로 대기한 횟수 */
+} trace_pipeline_t;
+
+static int spsc_push(spsc_ring_t *r, trace_batch_t *b) {
+    size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (tail - r->cached_head == PIPE_RING_SIZE) {
+        r->cached_head = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (tail - r->cached_head == PIPE_RING_SIZE) {
+            return 0;
+        }
+    }
+    r->slots[tail & (PIPE_RING_SIZE - 1)] = b;
+    atomic_store_explicit(&r->tail, tail + 1, memory_order_release);
+    return 1;
+}
+
+static trace_batch_t *spsc_pop(spsc_ring_t *r) {
+    size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (head == r->cached_tail) {
+        r->cached_tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (head == r->cached_tail) {
+            return NULL;
+        }
+    }
+    trace_batch_t *b = r->slots[head & (PIPE_RING_SIZE - 1)];
+    atomic_store_explicit(&r->head, head + 1, memory_order_release);
+    return b;
+}
+
+/* 링이 비었거나 가득 찼을 때의 대기: 잠깐 스핀한 뒤 양보 */
+static void spsc_wait(unsigned *spins) {
+    if (++*spins < 64) {
+#if defined(__aarch64__)
+        __asm__ volatile("yield");
+#elif defined(__x86_64__) || defined(__i386__)
+        __asm__ volatile("pause");
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+static void spsc_push_wait(spsc_ring_t *r, trace_batch_t *b, uint64_t *stalls) {
+    unsigned spins = 0;
+    while (!spsc_push(r, b)) {
+        if (stalls && spins == 0) {
+            (*stalls)++;
+        }
+        spsc_wait(&spins);
+    }
+}
+
+static trace_batch_t *spsc_pop_wait(spsc_ring_t *r, uint64_t *stalls) {
+    unsigned spins = 0;
+    trace_batch_t *b;
+    while ((b = spsc_pop(r)) == NULL) {
+        if (stalls && spins == 0) {
+            (*stalls)++;
+        }
+        spsc_wait(&spins);
+    }
+    return b;
+}
+
+/* dedup 스테이지의 PC 집합 (open addressing, 0 은 빈 슬롯) */
+static int pipeline_set_insert(trace_pipeline_t *tp, uint64_t pc);
+
+static int pipeline_set_grow(trace_pipeline_t *tp) {
+    size_t old_cap = tp->set_cap;
+    uint64_t *old = tp->set;
+    tp->set_cap = old_cap ? old_cap * 2 : PIPE_DEDUP_INIT;
+    tp->set = calloc(tp->set_cap, sizeof(uint64_t));
+    if (!tp->set) {
+        tp->set = old;
+        tp->set_cap = old_cap;
+        return ENOMEM;
+    }
+    tp->set_count = 0;
+    for (size_t i = 0; i < old_cap; i++) {
+        if (old[i]) {
+            pipeline_set_insert(tp, old[i]);
+        }
+    }
+    free(old);
+    return 0;
+}
+
+static int pipeline_set_insert(trace_pipeline_t *tp, uint64_t pc) {
+    if (pc == 0) {
+        return 0;
+    }
+    if ((tp->set_count + 1) * 4 > tp->set_cap * 3 && pipeline_set_grow(tp) != 0) {
+        return 0;
+    }
+    size_t mask = tp->set_cap - 1;
+    size_t i = (size_t)((pc * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+    while (tp->set[i]) {
+        if (tp->set[i] == pc) {
+            return 0;
+        }
+        i = (i + 1) & mask;
+    }
+    tp->set[i] = pc;
+    tp->set_count++;
+    return 1;
+}
+
+/* 분석 스테이지 1: 고유 PC 집계 */
+static void *pipeline_dedup_thread(void *arg) {
+    trace_pipeline_t *tp = (trace_pipeline_t *)arg;
+    for (;;) {
+        trace_batch_t *b = spsc_pop_wait(&tp->to_dedup, NULL);
+        for (uint32_t i = 0; i < b->count; i++) {
+            pipeline_set_insert(tp, b->pcs[i]);
+        }
+        tp->dedup_batches++;
+        int last = b->last;
+        spsc_push_wait(&tp->to_export, b, NULL);
+        if (last) {
+            return NULL;
+        }
+    }
+}
+
+/* 분석 스테이지 2: 원시 PC 스트림 내보내기 후 버퍼를 풀로 반환 */
+static void *pipeline_export_thread(void *arg) {
+    trace_pipeline_t *tp = (trace_pipeline_t *)arg;
+    for (;;) {
+        trace_batch_t *b = spsc_pop_wait(&tp->to_export, NULL);
+        if (tp->out && b->count) {
+            fwrite(b->pcs, sizeof(uint64_t), b->count, tp->out);
+        }
+        tp->exported += b->count;
+        tp->export_batches++;
+        int last = b->last;
+        spsc_push_wait(&tp->free_pool, b, NULL);
+        if (last) {
+            return NULL;
+        }
+    }
+}
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * 측정 스레드의 안전 지점(워크로드 조각 사이)에서 호출합니다.
+ * 주기가 지났으면 측정을 멈추고 폴딩한 뒤 다시 시작하므로 커널의 ++ 와 경합하지 않습니다.
+ */
+static void harvest_safepoint(harvest_state_t *hs) {
+    if (monotonic_ns() - hs->last_ns < (uint64_t)hs->interval_us * 1000ULL) {
+        return;
+    }
+    ksancov_stop(hs->counters);
+    harvest_adapt(hs, harvest_fold(hs));
+    hs->last_ns = monotonic_ns();
+    ksancov_start(hs->counters);
+}
+
 /* 테스트용 시스템 콜들을 실행하는 함수 */
 static void perform_test_operations(void) {
     printf("=== 커버리지 측정을 위한 테스트 작업 시작 ===\n");
@@ -318,11 +685,13 @@ static void test_counters_mode(void) {
     printf("\n=== COUNTERS 모드 결과 ===\n");
     uint32_t hit_edges = 0;
     uint32_t total_hits = 0;
+    uint32_t saturated = 0;
     
     for (uint32_t i = 0; i < counters->kc_nedges; i++) {
         if (counters->kc_hits[i] > 0) {
             hit_edges++;
             total_hits += counters->kc_hits[i];
+            if (counters->kc_hits[i] == UINT8_MAX) saturated++;
         }
     }
     
@@ -330,6 +699,9 @@ static void test_counters_mode(void) {
     printf("히트된 에지 수: %u (%.2f%%)\n", 
            hit_edges, (float)hit_edges / counters->kc_nedges * 100.0f);
     printf("총 히트 수: %u\n", total_hits);
+    if (saturated > 0) {
+        printf("포화(255)된 에지 수: %u - 정확한 값은 harvest 모드를 사용하세요.\n", saturated);
+    }
     
     if (hit_edges > 0) {
         printf("\n히트된 에지들 (처음 10개):\n");
@@ -348,6 +720,271 @@ static void test_counters_mode(void) {
     close(fd);
 }
 
+/* 8비트 포화 없이 COUNTERS 모드 측정 (하베스트 모드) */
+static void test_counters_harvest_mode(void) {
+    printf("\n========== COUNTERS 하베스트 모드 테스트 ==========\n");
+    
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open 실패");
+        return;
+    }
+    
+    int ret = ksancov_mode_counters(fd);
+    if (ret) {
+        printf("COUNTERS 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return;
+    }
+    
+    uintptr_t buf_addr;
+    size_t buf_size;
+    ret = ksancov_map(fd, &buf_addr, &buf_size);
+    if (ret) {
+        printf("버퍼 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return;
+    }
+    ksancov_counters_t *counters = (ksancov_counters_t *)buf_addr;
+    
+    uintptr_t edgemap_addr;
+    ksancov_edgemap_t *edgemap = NULL;
+    if (ksancov_map_edgemap(fd, &edgemap_addr, NULL) == 0) {
+        edgemap = (ksancov_edgemap_t *)edgemap_addr;
+    }
+    
+    harvest_state_t hs = {0};
+    hs.counters = counters;
+    hs.interval_us = 1000;
+    hs.shadow = calloc(counters->kc_nedges, sizeof(uint64_t));
+    if (!hs.shadow) {
+        printf("섀도 배열 할당 실패\n");
+        close(fd);
+        return;
+    }
+    
+    // 측정 스레드에 커버리지 연결 (폴딩도 이 스레드의 안전 지점에서 수행)
+    ret = ksancov_thread_self(fd);
+    if (ret) {
+        printf("스레드 설정 실패: %s\n", strerror(ret));
+        free(hs.shadow);
+        close(fd);
+        return;
+    }
+    
+    ksancov_reset_counters(counters);
+    hs.last_ns = monotonic_ns();
+    ksancov_start(counters);
+    printf("커버리지 측정 시작 (하베스트 주기 %u us)...\n", hs.interval_us);
+    
+    perform_test_operations();
+    harvest_safepoint(&hs);
+    for (int i = 0; i < HARVEST_HOT_ITERATIONS; i++) {
+        getppid();
+        harvest_safepoint(&hs);
+    }
+    
+    ksancov_stop(counters);
+    harvest_fold(&hs);   // 마지막 남은 카운터 수집
+    printf("커버리지 측정 중지\n");
+    
+    // 통계 및 탑-K
+    uint32_t hit_edges = 0;
+    uint64_t total_hits = 0;
+    harvest_top_t heap[HARVEST_TOPK];
+    size_t heap_n = 0;
+    for (uint32_t i = 0; i < counters->kc_nedges; i++) {
+        uint64_t h = hs.shadow[i];
+        if (h == 0) {
+            continue;
+        }
+        hit_edges++;
+        total_hits += h;
+        if (heap_n < HARVEST_TOPK) {
+            heap[heap_n++] = (harvest_top_t){ h, i };
+            if (heap_n == HARVEST_TOPK) {
+                for (size_t k = HARVEST_TOPK / 2; k-- > 0;) {
+                    harvest_top_sift_down(heap, heap_n, k);
+                }
+            }
+        } else if (h > heap[0].hits) {
+            heap[0] = (harvest_top_t){ h, i };
+            harvest_top_sift_down(heap, heap_n, 0);
+        }
+    }
+    qsort(heap, heap_n, sizeof(heap[0]), harvest_top_cmp);
+    
+    printf("\n=== COUNTERS 하베스트 모드 결과 ===\n");
+    printf("하베스트 횟수: %llu, 마지막 주기: %u us\n",
+           (unsigned long long)hs.rounds, hs.interval_us);
+    printf("히트된 에지 수: %u / %u\n", hit_edges, counters->kc_nedges);
+    if (hs.saturated == 0) {
+        printf("총 히트 수 (정확): %llu\n", (unsigned long long)total_hits);
+    } else {
+        printf("총 히트 수 (하한): %llu\n", (unsigned long long)total_hits);
+        printf("경고: 한 주기 안에 포화(255)된 카운터 %llu건 - 그 구간의 히트는 255로 잘렸습니다.\n",
+               (unsigned long long)hs.saturated);
+    }
+    
+    printf("\n가장 많이 실행된 에지 (상위 %zu개):\n", heap_n);
+    for (size_t k = 0; k < heap_n; k++) {
+        uintptr_t addr = edgemap ? edgemap->ke_addrs[heap[k].idx] : 0;
+        printf("  에지 %u: %llu회 히트", heap[k].idx, (unsigned long long)heap[k].hits);
+        if (addr) printf(" (주소: 0x%lx)", addr);
+        printf("\n");
+    }
+    
+    free(hs.shadow);
+    close(fd);
+}
+
+/*
+ * TRACE 모드 파이프라인 측정
+ * collector(측정 스레드)는 윈도우마다 kt_entries 를 풀 배치에 복사해 링으로 넘기고 곧바로
+ * 다음 윈도우를 시작합니다. dedup / export 스테이지는 다른 스레드에서 동시에 처리하며,
+ * 풀이 비면 collector 가 기다리는 방식으로 백프레셔가 걸립니다.
+ */
+static void test_trace_pipeline_mode(const char *out_path) {
+    printf("\n========== TRACE 파이프라인 모드 테스트 ==========\n");
+    
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open 실패");
+        return;
+    }
+    
+    size_t max_entries = 64 * 1024;
+    int ret = ksancov_mode_trace(fd, max_entries);
+    if (ret) {
+        printf("TRACE 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return;
+    }
+    
+    uintptr_t buf_addr;
+    size_t buf_size;
+    ret = ksancov_map(fd, &buf_addr, &buf_size);
+    if (ret) {
+        printf("버퍼 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return;
+    }
+    ksancov_trace_t *trace = (ksancov_trace_t *)buf_addr;
+    
+    trace_pipeline_t *tp = aligned_alloc(PIPE_CACHE_LINE, sizeof(*tp));
+    trace_batch_t *pool = calloc(PIPE_POOL_SIZE, sizeof(trace_batch_t));
+    if (!tp || !pool) {
+        printf("파이프라인 메모리 할당 실패\n");
+        free(tp);
+        free(pool);
+        close(fd);
+        return;
+    }
+    memset(tp, 0, sizeof(*tp));
+    if (pipeline_set_grow(tp) != 0) {
+        printf("파이프라인 메모리 할당 실패\n");
+        free(tp);
+        free(pool);
+        close(fd);
+        return;
+    }
+    if (out_path) {
+        tp->out = fopen(out_path, "wb");
+        if (!tp->out) {
+            printf("출력 파일 열기 실패 (%s): %s\n", out_path, strerror(errno));
+        }
+    }
+    for (int i = 0; i < PIPE_POOL_SIZE; i++) {
+        spsc_push(&tp->free_pool, &pool[i]);
+    }
+    
+    ret = ksancov_thread_self(fd);
+    if (ret) {
+        printf("스레드 설정 실패: %s\n", strerror(ret));
+        goto out;
+    }
+    
+    pthread_t dedup, exporter;
+    ret = pthread_create(&dedup, NULL, pipeline_dedup_thread, tp);
+    if (ret) {
+        printf("dedup 스레드 생성 실패: %s\n", strerror(ret));
+        goto out;
+    }
+    ret = pthread_create(&exporter, NULL, pipeline_export_thread, tp);
+    if (ret) {
+        printf("내보내기 스레드 생성 실패: %s\n", strerror(ret));
+        // dedup 스테이지만 종료 배치로 멈춤 (배치는 비어 있는 to_export 링에 남음)
+        trace_batch_t *stop = spsc_pop_wait(&tp->free_pool, NULL);
+        stop->count = 0;
+        stop->last = 1;
+        spsc_push_wait(&tp->to_dedup, stop, NULL);
+        pthread_join(dedup, NULL);
+        goto out;
+    }
+
+    uint64_t measure_ns = 0, handoff_ns = 0;
+    uint64_t collected = 0;
+    uint64_t t_begin = monotonic_ns();
+    
+    for (uint32_t w = 0; w < PIPE_WINDOWS; w++) {
+        uint64_t t0 = monotonic_ns();
+        ksancov_reset_trace(trace);
+        ksancov_start(trace);
+        perform_test_operations();
+        ksancov_stop(trace);
+        uint64_t t1 = monotonic_ns();
+        
+        uint32_t head = atomic_load_explicit(&trace->kt_head, memory_order_acquire);
+        head = head < trace->kt_maxent ? head : trace->kt_maxent;
+        
+        // 배치로 나눠서 넘기기 - 분석은 다음 윈도우와 겹쳐서 진행됨
+        for (uint32_t off = 0; off < head; off += PIPE_BATCH_ENTRIES) {
+            trace_batch_t *b = spsc_pop_wait(&tp->free_pool, &tp->stalls);
+            b->window = w;
+            b->last = 0;
+            b->count = head - off < PIPE_BATCH_ENTRIES ? head - off : PIPE_BATCH_ENTRIES;
+            memcpy(b->pcs, &trace->kt_entries[off], b->count * sizeof(uint64_t));
+            spsc_push_wait(&tp->to_dedup, b, &tp->stalls);
+        }
+        collected += head;
+        measure_ns += t1 - t0;
+        handoff_ns += monotonic_ns() - t1;
+    }
+    
+    // 종료 배치를 흘려보내고 스테이지 종료 대기
+    trace_batch_t *end = spsc_pop_wait(&tp->free_pool, &tp->stalls);
+    end->count = 0;
+    end->last = 1;
+    spsc_push_wait(&tp->to_dedup, end, &tp->stalls);
+    uint64_t t_collect_done = monotonic_ns();
+    pthread_join(dedup, NULL);
+    pthread_join(exporter, NULL);
+    uint64_t t_end = monotonic_ns();
+    
+    printf("\n=== TRACE 파이프라인 모드 결과 ===\n");
+    printf("측정 윈도우 수: %d\n", PIPE_WINDOWS);
+    printf("수집된 PC 엔트리 수: %llu (내보낸 수: %llu)\n",
+           (unsigned long long)collected, (unsigned long long)tp->exported);
+    printf("고유 PC 수: %zu\n", tp->set_count);
+    printf("윈도우당 측정 시간: %.3f ms, 넘기기 시간: %.3f ms\n",
+           measure_ns / 1e6 / PIPE_WINDOWS, handoff_ns / 1e6 / PIPE_WINDOWS);
+    printf("수집 완료까지: %.3f ms, 분석 잔여 시간: %.3f ms\n",
+           (t_collect_done - t_begin) / 1e6, (t_end - t_collect_done) / 1e6);
+    printf("백프레셔 대기 횟수: %llu\n", (unsigned long long)tp->stalls);
+    if (tp->out) {
+        printf("원시 PC 스트림 저장: %s\n", out_path);
+    }
+    
+out:
+    if (tp->out) {
+        fclose(tp->out);
+    }
+    free(tp->set);
+    free(tp);
+    free(pool);
+    close(fd);
+}
+
 int main(int argc, char *argv[]) {
     printf("XNU 커널 커버리지 측정 데모\n");
     printf("============================\n");
@@ -361,6 +998,19 @@ int main(int argc, char *argv[]) {
     
     printf("ksancov 디바이스 발견: %s\n", KSANCOV_PATH);
     
+    if (argc > 1) {
+        if (strcmp(argv[1], "harvest") == 0) {
+            test_counters_harvest_mode();
+            return 0;
+        }
+        if (strcmp(argv[1], "pipeline") == 0) {
+            test_trace_pipeline_mode(argc > 2 ? argv[2] : NULL);
+            return 0;
+        }
+        printf("사용법: %s [harvest | pipeline [출력파일]]\n", argv[0]);
+        return 1;
+    }
+    
     // TRACE 모드 테스트
     test_trace_mode();
     
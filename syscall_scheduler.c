@@ -0,0 +1,746 @@
+/*
+ * 커버리지 기반 시스템 콜 워크로드 스케줄러
+ *
+ * simple_coverage_test.c 의 perform_test_operations() 는 매번 같은 인자로 같은 작업을 하므로
+ * 항상 같은 엣지만 도달합니다. 이 도구는 같은 종류의 작업(파일, 프로세스, 메모리, 시간, 소켓)을
+ * "시스템 콜 시퀀스 입력"으로 표현하고 다음 피드백 루프를 돌립니다.
+ *
+ *   1. 큐에서 입력을 고르고 에너지(power schedule)만큼 변이(인자 값, 순서, 플래그)
+ *   2. 변이된 입력을 COUNTERS 세션 안에서 실행
+ *   3. 새 엣지에 도달하면 큐에 추가
+ *
+ * 에너지는 입력이 처음 찾은 엣지 중 가장 드문 엣지의 히트 빈도에 반비례하므로,
+ * 드문 엣지에 도달하는 입력일수록 더 많이 변이됩니다.
+ *
+ * 처리량을 위해 입력은 fork 없이 측정 스레드에서 바로 실행하고, 카운터 확인과 리셋은
+ * 0이 아닌 8바이트 워드만 건드리며, 실행 중에는 출력이나 동적 할당을 하지 않습니다.
+ *
+ * 컴파일: gcc -O2 -o syscall_scheduler syscall_scheduler.c
+ * 실행: sudo ./syscall_scheduler [-t 초] [-s 시드] [-o 통계.csv]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+
+/* ksancov 헤더 파일에서 필요한 정의들 */
+#define KSANCOV_PATH "/dev/ksancov"
+
+/* ioctl 명령어들 */
+#define KSANCOV_IOC_COUNTERS     _IO('K', 2)
+#define KSANCOV_IOC_MAP          _IOWR('K', 8, struct ksancov_buf_desc)
+#define KSANCOV_IOC_START        _IOW('K', 10, uintptr_t)
+
+/* 매직 넘버들 */
+#define KSANCOV_COUNTERS_MAGIC  (uint32_t)0x5AD27F6BU
+
+/* 버퍼 설명자 */
+struct ksancov_buf_desc {
+    uintptr_t ptr;
+    size_t sz;
+};
+
+/* 공통 헤더 */
+typedef struct ksancov_header {
+    uint32_t         kh_magic;
+    _Atomic uint32_t kh_enabled;
+} ksancov_header_t;
+
+/* COUNTERS 모드 구조체 */
+typedef struct ksancov_counters {
+    ksancov_header_t kc_hdr;
+    uint32_t         kc_nedges;
+    uint8_t          kc_hits[];
+} ksancov_counters_t;
+
+/* 스케줄러 설정 */
+#define SCHED_MAX_OPS        16      /* 입력 하나의 최대 시스템 콜 작업 수 */
+#define SCHED_MAX_FDS        8       /* 실행 중 열어둘 수 있는 fd 수 */
+#define SCHED_QUEUE_MAX      8192
+#define SCHED_ENERGY_BASE    16
+#define SCHED_ENERGY_MAX     1024
+#define SCHED_IO_BUF         4096
+
+/* 작업 종류 */
+typedef enum {
+    OP_OPEN,        /* 임시 파일 열기 (플래그 변이) */
+    OP_WRITE,
+    OP_READ,
+    OP_FSYNC,
+    OP_FCNTL,
+    OP_CLOSE,
+    OP_GETID,       /* getpid / getppid / getuid / getgid */
+    OP_MMAP,        /* 익명 매핑 + 접근 + 해제 */
+    OP_MPROTECT,
+    OP_TIME,        /* time / gettimeofday / clock_gettime */
+    OP_SOCKET,      /* 소켓 생성 (도메인/타입 변이) */
+    OP_SETSOCKOPT,
+    OP_PIPE,
+    OP_STAT,
+    OP_KIND_MAX
+} sched_op_kind_t;
+
+typedef struct sched_op {
+    uint8_t  kind;
+    uint8_t  flags;
+    uint16_t fd_slot;
+    uint32_t arg0;
+    uint32_t arg1;
+} sched_op_t;
+
+/* 큐 엔트리 */
+typedef struct sched_input {
+    uint32_t   nops;
+    sched_op_t ops[SCHED_MAX_OPS];
+    uint32_t   rare_edge;     /* 이 입력이 처음 찾은 엣지 중 가장 드문 것 */
+    uint32_t   new_edges;     /* 추가될 때 찾은 새 엣지 수 */
+    uint32_t   fuzzed;        /* 선택된 횟수 */
+} sched_input_t;
+
+/* 스케줄러 상태 */
+typedef struct sched {
+    ksancov_counters_t *counters;
+    uint8_t            *virgin;       /* 한 번이라도 히트된 엣지 */
+    uint32_t           *freq;         /* 엣지를 히트한 실행 수 */
+    uint32_t            nedges;
+    sched_input_t      *queue;
+    uint32_t            queue_len;
+    uint64_t            execs;
+    uint64_t            edges;
+    uint64_t            rng;
+    uint8_t             io_buf[SCHED_IO_BUF];
+} sched_t;
+
+/* 헬퍼 함수들 */
+static int ksancov_open(void) {
+    return open(KSANCOV_PATH, O_RDWR);
+}
+
+static int ksancov_map(int fd, uintptr_t *buf, size_t *sz) {
+    struct ksancov_buf_desc mc = {0};
+    int ret = ioctl(fd, KSANCOV_IOC_MAP, &mc);
+    if (ret == -1) {
+        return errno;
+    }
+    *buf = mc.ptr;
+    if (sz) {
+        *sz = mc.sz;
+    }
+    return 0;
+}
+
+static int ksancov_mode_counters(int fd) {
+    int ret = ioctl(fd, KSANCOV_IOC_COUNTERS);
+    return (ret == -1) ? errno : 0;
+}
+
+static int ksancov_thread_self(int fd) {
+    uintptr_t th = 0;
+    int ret = ioctl(fd, KSANCOV_IOC_START, &th);
+    return (ret == -1) ? errno : 0;
+}
+
+static void ksancov_start(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 1, memory_order_relaxed);
+}
+
+static void ksancov_stop(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 0, memory_order_relaxed);
+}
+
+/* ---- 난수 ---- */
+
+static inline uint64_t sched_rand(sched_t *s) {
+    uint64_t x = s->rng;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    s->rng = x;
+    return x;
+}
+
+static inline uint32_t sched_below(sched_t *s, uint32_t n) {
+    return (uint32_t)(((sched_rand(s) >> 32) * n) >> 32);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* ---- 입력 실행 ---- */
+
+/*
+ * 스크래치 파일은 시작할 때 mkdtemp 로 만든 전용 디렉토리(0700) 안에 둡니다.
+ * root 로 실행되므로 누구나 쓸 수 있는 /tmp 에 고정 이름을 쓰면, 매 실행 전 unlink 와
+ * open 사이에 다른 사용자가 심어 둔 심볼릭 링크를 따라가 임의 파일을 덮어쓸 수 있습니다.
+ */
+static char sched_dir[64];
+static char sched_paths[2][80];
+static const char *const sched_stat_paths[] = { "/", "/tmp", "/dev/null", "/nonexistent/kcov" };
+
+static int sched_open_flags(uint8_t flags) {
+    int f = O_RDWR | O_CREAT | O_NOFOLLOW;
+    if (flags & 1) f |= O_TRUNC;
+    if (flags & 2) f |= O_APPEND;
+    if (flags & 4) f |= O_NONBLOCK;
+    if (flags & 8) f |= O_EXCL;
+    return f;
+}
+
+static int sched_take_fd(int *fds, int *nfds, uint16_t slot) {
+    return *nfds ? fds[slot % *nfds] : -1;
+}
+
+static void sched_push_fd(int *fds, int *nfds, int fd) {
+    if (fd < 0) {
+        return;
+    }
+    if (*nfds < SCHED_MAX_FDS) {
+        fds[(*nfds)++] = fd;
+    } else {
+        close(fd);
+    }
+}
+
+/* 입력의 시스템 콜 시퀀스를 실행. 실행 중에는 출력/할당을 하지 않음 */
+static void sched_execute(sched_t *s, const sched_input_t *in) {
+    int fds[SCHED_MAX_FDS];
+    int nfds = 0;
+
+    for (uint32_t i = 0; i < in->nops; i++) {
+        const sched_op_t *op = &in->ops[i];
+        int fd = sched_take_fd(fds, &nfds, op->fd_slot);
+
+        switch (op->kind) {
+        case OP_OPEN:
+            sched_push_fd(fds, &nfds, open(sched_paths[op->arg0 & 1], sched_open_flags(op->flags), 0644));
+            break;
+        case OP_WRITE:
+            if (fd >= 0) write(fd, s->io_buf, op->arg0 % SCHED_IO_BUF);
+            break;
+        case OP_READ:
+            if (fd >= 0) {
+                if (op->flags & 1) {
+                    pread(fd, s->io_buf, op->arg0 % SCHED_IO_BUF, (off_t)(op->arg1 % 65536));
+                } else {
+                    read(fd, s->io_buf, op->arg0 % SCHED_IO_BUF);
+                }
+            }
+            break;
+        case OP_FSYNC:
+            if (fd >= 0) fsync(fd);
+            break;
+        case OP_FCNTL:
+            if (fd >= 0) {
+                switch (op->arg0 % 4) {
+                case 0: fcntl(fd, F_GETFL); break;
+                /* O_NONBLOCK 은 항상 유지 (소켓 read 가 멈추지 않도록) */
+                case 1: fcntl(fd, F_SETFL, O_NONBLOCK | ((op->flags & 1) ? O_APPEND : 0)); break;
+                case 2: fcntl(fd, F_GETFD); break;
+                default: fcntl(fd, F_SETFD, (op->flags & 1) ? FD_CLOEXEC : 0); break;
+                }
+            }
+            break;
+        case OP_CLOSE:
+            if (nfds) {
+                int idx = op->fd_slot % nfds;
+                close(fds[idx]);
+                fds[idx] = fds[--nfds];
+            }
+            break;
+        case OP_GETID:
+            switch (op->arg0 % 4) {
+            case 0: getpid(); break;
+            case 1: getppid(); break;
+            case 2: getuid(); break;
+            default: getgid(); break;
+            }
+            break;
+        case OP_MMAP:
+        case OP_MPROTECT: {
+            size_t len = 4096 * (size_t)(1 + op->arg0 % 64);
+            int prot = (op->flags & 1) ? PROT_READ : (PROT_READ | PROT_WRITE);
+            int mflags = MAP_ANON | ((op->flags & 2) ? MAP_SHARED : MAP_PRIVATE);
+            uint8_t *p = mmap(NULL, len, prot, mflags, -1, 0);
+            if (p != MAP_FAILED) {
+                if (op->kind == OP_MPROTECT) {
+                    mprotect(p, len, (op->flags & 4) ? PROT_NONE : (PROT_READ | PROT_WRITE));
+                    if (!(op->flags & 4)) p[(op->arg1 % len) & ~(size_t)7] = 1;
+                } else if (prot & PROT_WRITE) {
+                    p[(op->arg1 % len) & ~(size_t)7] = 1;
+                }
+                munmap(p, len);
+            }
+            break;
+        }
+        case OP_TIME: {
+            struct timeval tv;
+            struct timespec ts;
+            switch (op->arg0 % 3) {
+            case 0: time(NULL); break;
+            case 1: gettimeofday(&tv, NULL); break;
+            default: clock_gettime((op->flags & 1) ? CLOCK_MONOTONIC : CLOCK_REALTIME, &ts); break;
+            }
+            break;
+        }
+        case OP_SOCKET: {
+            static const int domains[] = { AF_INET, AF_INET6, AF_UNIX };
+            static const int types[] = { SOCK_STREAM, SOCK_DGRAM };
+            int sock = socket(domains[op->arg0 % 3], types[op->arg1 % 2], 0);
+            if (sock >= 0) {
+                fcntl(sock, F_SETFL, O_NONBLOCK);
+            }
+            sched_push_fd(fds, &nfds, sock);
+            break;
+        }
+        case OP_SETSOCKOPT:
+            if (fd >= 0) {
+                static const int opts[] = { SO_REUSEADDR, SO_KEEPALIVE, SO_SNDBUF, SO_RCVBUF };
+                int v = (int)(op->arg1 % 65536);
+                setsockopt(fd, SOL_SOCKET, opts[op->arg0 % 4], &v, sizeof(v));
+            }
+            break;
+        case OP_PIPE: {
+            int p[2];
+            if (pipe(p) == 0) {
+                size_t len = 1 + op->arg0 % 512;
+                write(p[1], s->io_buf, len);
+                read(p[0], s->io_buf, len);
+                close(p[0]);
+                close(p[1]);
+            }
+            break;
+        }
+        case OP_STAT: {
+            struct stat st;
+            const char *path = sched_stat_paths[op->arg0 % 4];
+            if (op->flags & 1) lstat(path, &st); else stat(path, &st);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    for (int i = 0; i < nfds; i++) {
+        close(fds[i]);
+    }
+}
+
+/*
+ * 실행 결과 확인: 0이 아닌 8바이트 워드만 검사하고 그 워드만 0으로 되돌립니다.
+ * 새로 히트된 엣지 수를 반환하고, 그 중 가장 드문 엣지를 *rare 에 기록합니다.
+ */
+static uint32_t sched_collect(sched_t *s, uint32_t *rare) {
+    uint8_t *hits = s->counters->kc_hits;
+    uint32_t n = s->nedges;
+    uint32_t new_edges = 0;
+    uint32_t rare_freq = UINT32_MAX;
+
+    uint32_t w = 0;
+    for (; w + 8 <= n; w += 8) {
+        uint64_t x;
+        memcpy(&x, hits + w, sizeof(x));
+        if (x == 0) {
+            continue;
+        }
+        for (uint32_t k = 0; k < 8; k++) {
+            if (hits[w + k] == 0) {
+                continue;
+            }
+            uint32_t e = w + k;
+            if (s->freq[e] != UINT32_MAX) {
+                s->freq[e]++;
+            }
+            if (!s->virgin[e]) {
+                s->virgin[e] = 1;
+                new_edges++;
+            }
+            if (s->freq[e] < rare_freq) {
+                rare_freq = s->freq[e];
+                *rare = e;
+            }
+        }
+        memset(hits + w, 0, 8);
+    }
+    for (; w < n; w++) {
+        if (hits[w] == 0) {
+            continue;
+        }
+        if (s->freq[w] != UINT32_MAX) {
+            s->freq[w]++;
+        }
+        if (!s->virgin[w]) {
+            s->virgin[w] = 1;
+            new_edges++;
+        }
+        if (s->freq[w] < rare_freq) {
+            rare_freq = s->freq[w];
+            *rare = w;
+        }
+        hits[w] = 0;
+    }
+    return new_edges;
+}
+
+/*
+ * 측정 구간 밖에서 스크래치 파일을 지워 매 실행이 같은 파일 상태에서 시작하도록 합니다.
+ * (O_APPEND 입력이 파일을 계속 키워 /tmp 를 채우거나, 크기에 따라 다른 커널 경로를 타서
+ *  새 엣지 판정이 흔들리는 것을 막음)
+ */
+static void sched_reset_files(void) {
+    unlink(sched_paths[0]);
+    unlink(sched_paths[1]);
+}
+
+static int sched_setup_files(void) {
+    snprintf(sched_dir, sizeof(sched_dir), "/tmp/kcov_sched.XXXXXX");
+    if (!mkdtemp(sched_dir)) {
+        return errno;
+    }
+    snprintf(sched_paths[0], sizeof(sched_paths[0]), "%s/a", sched_dir);
+    snprintf(sched_paths[1], sizeof(sched_paths[1]), "%s/b", sched_dir);
+    return 0;
+}
+
+static void sched_cleanup_files(void) {
+    sched_reset_files();
+    rmdir(sched_dir);
+}
+
+static uint32_t sched_run(sched_t *s, const sched_input_t *in, uint32_t *rare) {
+    sched_reset_files();
+    ksancov_start(s->counters);
+    sched_execute(s, in);
+    ksancov_stop(s->counters);
+    s->execs++;
+    return sched_collect(s, rare);
+}
+
+/* ---- 변이 ---- */
+
+static const uint32_t interesting_values[] = {
+    0, 1, 2, 7, 8, 63, 64, 127, 128, 255, 256, 511, 512, 1023, 1024, 4095, 4096, 65535, 0xffffffffU
+};
+
+static void sched_random_op(sched_t *s, sched_op_t *op) {
+    op->kind = (uint8_t)sched_below(s, OP_KIND_MAX);
+    op->flags = (uint8_t)sched_rand(s);
+    op->fd_slot = (uint16_t)sched_below(s, SCHED_MAX_FDS);
+    op->arg0 = (uint32_t)sched_rand(s);
+    op->arg1 = (uint32_t)sched_rand(s);
+}
+
+static uint32_t sched_mutate_value(sched_t *s, uint32_t v) {
+    switch (sched_below(s, 4)) {
+    case 0: return interesting_values[sched_below(s, sizeof(interesting_values) / sizeof(interesting_values[0]))];
+    case 1: return v + 1 + sched_below(s, 16);
+    case 2: return v - 1 - sched_below(s, 16);
+    default: return (uint32_t)sched_rand(s);
+    }
+}
+
+static void sched_mutate(sched_t *s, sched_input_t *in) {
+    uint32_t rounds = 1 + sched_below(s, 4);
+    for (uint32_t r = 0; r < rounds; r++) {
+        uint32_t i = in->nops ? sched_below(s, in->nops) : 0;
+        switch (sched_below(s, 7)) {
+        case 0:     /* 인자 값 */
+            if (in->nops) in->ops[i].arg0 = sched_mutate_value(s, in->ops[i].arg0);
+            break;
+        case 1:
+            if (in->nops) in->ops[i].arg1 = sched_mutate_value(s, in->ops[i].arg1);
+            break;
+        case 2:     /* 플래그 */
+            if (in->nops) in->ops[i].flags ^= (uint8_t)(1u << sched_below(s, 8));
+            break;
+        case 3:     /* fd 선택 */
+            if (in->nops) in->ops[i].fd_slot = (uint16_t)sched_below(s, SCHED_MAX_FDS);
+            break;
+        case 4:     /* 순서 교환 */
+            if (in->nops > 1) {
+                uint32_t j = sched_below(s, in->nops);
+                sched_op_t t = in->ops[i];
+                in->ops[i] = in->ops[j];
+                in->ops[j] = t;
+            }
+            break;
+        case 5:     /* 작업 삽입 */
+            if (in->nops < SCHED_MAX_OPS) {
+                uint32_t at = sched_below(s, in->nops + 1);
+                memmove(&in->ops[at + 1], &in->ops[at], (in->nops - at) * sizeof(sched_op_t));
+                sched_random_op(s, &in->ops[at]);
+                in->nops++;
+            }
+            break;
+        default:    /* 작업 삭제 또는 다른 큐 엔트리와 접합 */
+            if (s->queue_len > 1 && sched_below(s, 2)) {
+                const sched_input_t *other = &s->queue[sched_below(s, s->queue_len)];
+                uint32_t cut = sched_below(s, in->nops + 1);
+                uint32_t take = other->nops - sched_below(s, other->nops + 1);
+                if (cut + take > SCHED_MAX_OPS) take = SCHED_MAX_OPS - cut;
+                memcpy(&in->ops[cut], &other->ops[other->nops - take], take * sizeof(sched_op_t));
+                in->nops = cut + take;
+            } else if (in->nops > 1) {
+                memmove(&in->ops[i], &in->ops[i + 1], (in->nops - i - 1) * sizeof(sched_op_t));
+                in->nops--;
+            }
+            break;
+        }
+    }
+    if (in->nops == 0) {
+        sched_random_op(s, &in->ops[0]);
+        in->nops = 1;
+    }
+}
+
+/*
+ * 에너지: 입력의 가장 드문 엣지가 드물수록, 그리고 이미 많이 선택된 입력일수록 크게.
+ * (AFLFast 의 FAST 스케줄처럼 선택될 때마다 두 배씩(최대 2^8) 늘리고 엣지 빈도로 나눔)
+ */
+static uint32_t sched_energy(const sched_t *s, const sched_input_t *in) {
+    uint64_t f = s->freq[in->rare_edge] ? s->freq[in->rare_edge] : 1;
+    uint32_t shift = in->fuzzed < 8 ? in->fuzzed : 8;
+    uint64_t e = ((uint64_t)SCHED_ENERGY_BASE << shift) / f;
+    if (e < 1) e = 1;
+    if (e > SCHED_ENERGY_MAX) e = SCHED_ENERGY_MAX;
+    return (uint32_t)e;
+}
+
+static void sched_queue_add(sched_t *s, const sched_input_t *in, uint32_t new_edges, uint32_t rare) {
+    sched_input_t *slot;
+    if (s->queue_len < SCHED_QUEUE_MAX) {
+        slot = &s->queue[s->queue_len++];
+    } else {
+        /* 큐가 가득 차면 가장 흔한 엣지에 묶인 엔트리를 교체 */
+        uint32_t victim = 0;
+        for (uint32_t i = 1; i < s->queue_len; i++) {
+            if (s->freq[s->queue[i].rare_edge] > s->freq[s->queue[victim].rare_edge]) {
+                victim = i;
+            }
+        }
+        slot = &s->queue[victim];
+    }
+    *slot = *in;
+    slot->new_edges = new_edges;
+    slot->rare_edge = rare;
+    slot->fuzzed = 0;
+}
+
+/* perform_test_operations() 와 같은 작업으로 구성된 시드 입력 */
+static void sched_seed(sched_input_t *in) {
+    static const sched_op_t seed_ops[] = {
+        { OP_OPEN,   1, 0, 0,  0 },
+        { OP_WRITE,  0, 0, 24, 0 },
+        { OP_FSYNC,  0, 0, 0,  0 },
+        { OP_CLOSE,  0, 0, 0,  0 },
+        { OP_GETID,  0, 0, 0,  0 },
+        { OP_GETID,  0, 0, 1,  0 },
+        { OP_GETID,  0, 0, 2,  0 },
+        { OP_GETID,  0, 0, 3,  0 },
+        { OP_MMAP,   0, 0, 0,  0 },
+        { OP_TIME,   0, 0, 0,  0 },
+        { OP_SOCKET, 0, 0, 0,  0 },
+        { OP_CLOSE,  0, 0, 0,  0 },
+    };
+    memset(in, 0, sizeof(*in));
+    in->nops = sizeof(seed_ops) / sizeof(seed_ops[0]);
+    memcpy(in->ops, seed_ops, sizeof(seed_ops));
+}
+
+static const char *const op_names[OP_KIND_MAX] = {
+    "open", "write", "read", "fsync", "fcntl", "close", "getid", "mmap",
+    "mprotect", "time", "socket", "setsockopt", "pipe", "stat",
+};
+
+static void sched_print_input(const sched_input_t *in) {
+    for (uint32_t i = 0; i < in->nops; i++) {
+        const sched_op_t *op = &in->ops[i];
+        printf("%s%s(0x%x,%u,%u)", i ? " " : "    ", op_names[op->kind], op->flags, op->arg0, op->arg1);
+    }
+    printf("\n");
+}
+
+/* 메인 함수 */
+int main(int argc, char *argv[]) {
+    unsigned seconds = 60;
+    uint64_t seed = (uint64_t)time(NULL);
+    const char *csv_path = NULL;
+
+    printf("커버리지 기반 시스템 콜 스케줄러\n");
+    printf("================================\n");
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-t") == 0) {
+            seconds = (unsigned)strtoul(argv[i + 1], NULL, 10);
+        } else if (strcmp(argv[i], "-s") == 0) {
+            seed = strtoull(argv[i + 1], NULL, 0);
+        } else if (strcmp(argv[i], "-o") == 0) {
+            csv_path = argv[i + 1];
+        } else {
+            printf("사용법: %s [-t 초] [-s 시드] [-o 통계.csv]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open");
+        return errno;
+    }
+    int ret = ksancov_mode_counters(fd);
+    if (ret != 0) {
+        printf("COUNTERS 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    uintptr_t buf = 0;
+    ret = ksancov_map(fd, &buf, NULL);
+    if (ret != 0) {
+        printf("버퍼 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+
+    static sched_t sched;
+    sched_t *s = &sched;
+    s->counters = (ksancov_counters_t *)buf;
+    s->nedges = s->counters->kc_nedges;
+    s->rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    s->virgin = calloc(s->nedges, 1);
+    s->freq = calloc(s->nedges, sizeof(uint32_t));
+    s->queue = calloc(SCHED_QUEUE_MAX, sizeof(sched_input_t));
+    if (!s->virgin || !s->freq || !s->queue) {
+        printf("메모리 할당 실패\n");
+        close(fd);
+        return ENOMEM;
+    }
+    memset(s->io_buf, 'K', sizeof(s->io_buf));
+
+    /* 연결되지 않은 소켓에 write 하는 입력이 프로세스를 죽이지 않도록 */
+    signal(SIGPIPE, SIG_IGN);
+
+    FILE *csv = NULL;
+    if (csv_path) {
+        csv = fopen(csv_path, "w");
+        if (csv) {
+            fprintf(csv, "seconds,execs,execs_per_sec,edges,queue\n");
+        }
+    }
+
+    ret = ksancov_thread_self(fd);
+    if (ret != 0) {
+        printf("스레드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    memset(s->counters->kc_hits, 0, s->nedges);
+
+    ret = sched_setup_files();
+    if (ret != 0) {
+        printf("스크래치 디렉토리 생성 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+
+    printf("총 엣지 수: %u, 실행 시간: %u초, 시드: %llu\n\n", s->nedges, seconds, (unsigned long long)seed);
+
+    /* 시드 입력 실행 */
+    sched_input_t cur;
+    uint32_t rare = 0;
+    sched_seed(&cur);
+    uint32_t found = sched_run(s, &cur, &rare);
+    s->edges += found;
+    sched_queue_add(s, &cur, found, rare);
+
+    uint64_t t_start = now_ns();
+    uint64_t t_report = t_start;
+    uint64_t execs_report = 0;
+    uint32_t qi = 0;
+
+    for (;;) {
+        sched_input_t *parent = &s->queue[qi];
+        uint32_t energy = sched_energy(s, parent);
+        parent->fuzzed++;
+
+        for (uint32_t e = 0; e < energy; e++) {
+            cur = *parent;
+            sched_mutate(s, &cur);
+            found = sched_run(s, &cur, &rare);
+            if (found) {
+                s->edges += found;
+                sched_queue_add(s, &cur, found, rare);
+                parent = &s->queue[qi];
+            }
+        }
+        qi = (qi + 1) % s->queue_len;
+
+        uint64_t now = now_ns();
+        if (now - t_report >= 1000000000ULL) {
+            double elapsed = (double)(now - t_start) / 1e9;
+            double rate = (double)(s->execs - execs_report) / ((double)(now - t_report) / 1e9);
+            printf("[%6.1fs] 실행 %llu회 (%.0f/s), 엣지 %llu, 큐 %u\n", elapsed,
+                   (unsigned long long)s->execs, rate, (unsigned long long)s->edges, s->queue_len);
+            if (csv) {
+                fprintf(csv, "%.1f,%llu,%.0f,%llu,%u\n", elapsed, (unsigned long long)s->execs,
+                        rate, (unsigned long long)s->edges, s->queue_len);
+                fflush(csv);
+            }
+            t_report = now;
+            execs_report = s->execs;
+            if (elapsed >= seconds) {
+                break;
+            }
+        }
+    }
+
+    double total = (double)(now_ns() - t_start) / 1e9;
+    printf("\n=== 스케줄러 결과 ===\n");
+    printf("총 실행 수: %llu (평균 %.0f/s)\n", (unsigned long long)s->execs, s->execs / total);
+    printf("도달한 엣지 수: %llu / %u\n", (unsigned long long)s->edges, s->nedges);
+    printf("큐 크기: %u\n", s->queue_len);
+
+    printf("\n가장 드문 엣지를 가진 입력 (상위 5개):\n");
+    uint8_t *shown = calloc(s->queue_len, 1);
+    for (uint32_t n = 0; shown && n < 5 && n < s->queue_len; n++) {
+        uint32_t best = UINT32_MAX;
+        for (uint32_t i = 0; i < s->queue_len; i++) {
+            if (!shown[i] && (best == UINT32_MAX ||
+                              s->freq[s->queue[i].rare_edge] < s->freq[s->queue[best].rare_edge])) {
+                best = i;
+            }
+        }
+        shown[best] = 1;
+        printf("  엣지 %u (빈도 %u, 새 엣지 %u):\n", s->queue[best].rare_edge,
+               s->freq[s->queue[best].rare_edge], s->queue[best].new_edges);
+        sched_print_input(&s->queue[best]);
+    }
+    free(shown);
+
+    sched_cleanup_files();
+    if (csv) {
+        fclose(csv);
+    }
+    free(s->queue);
+    free(s->freq);
+    free(s->virgin);
+    close(fd);
+    return 0;
+}
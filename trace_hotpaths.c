@@ -0,0 +1,777 @@
+/*
+ * TRACE 스트림 핫 패스 분석기
+ *
+ * kt_entries 의 순서 정보를 이용해 가장 자주 나타나는 PC n-gram(연속된 n 개의 PC, 핫 패스)을
+ * 찾습니다. 수십억 엔트리도 한 번의 순회로 처리할 수 있도록 메모리는 입력 크기와 무관하게 고정입니다.
+ *
+ *  - count-min sketch (행 4개, conservative update) 로 모든 n-gram 의 빈도를 추정
+ *  - 추정치가 상위 K 최솟값을 넘는 n-gram 만 최소 힙 + 해시 테이블로 된 top-K 에 보관
+ *    (top-K 항목은 전체 PC 를 저장하므로 나중에 그대로 출력/심볼화 가능)
+ *  - n-gram 키는 rolling hash 로 PC 당 O(1) 갱신하고, sketch 카운터는 묶음 단위로 prefetch
+ *
+ * 입력은 원시 uint64 PC 스트림 파일(simple_coverage_test pipeline 출력 등, "-" 는 표준 입력)이거나
+ * 라이브 TRACE 캡처입니다. 주소 맵("주소 [타입] 심볼" 형식, nm 출력 그대로 가능)이 있으면
+ * 각 PC 를 심볼+오프셋으로 표시합니다. 커널 슬라이드는 --slide 로 빼 줍니다.
+ *
+ * 컴파일: gcc -O2 -o trace_hotpaths trace_hotpaths.c
+ * 실행:
+ *   ./trace_hotpaths file trace.bin [-n 4] [-k 20] [-w 20] [-s kernel.syms --slide 0x...]
+ *   sudo ./trace_hotpaths live [반복수] [-n 4] [-k 20]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+/* ksancov 헤더 파일에서 필요한 정의들 */
+#define KSANCOV_PATH "/dev/ksancov"
+
+/* ioctl 명령어들 */
+#define KSANCOV_IOC_TRACE        _IOW('K', 1, size_t)
+#define KSANCOV_IOC_MAP          _IOWR('K', 8, struct ksancov_buf_desc)
+#define KSANCOV_IOC_START        _IOW('K', 10, uintptr_t)
+
+/* 버퍼 설명자 */
+struct ksancov_buf_desc {
+    uintptr_t ptr;
+    size_t sz;
+};
+
+/* 공통 헤더 */
+typedef struct ksancov_header {
+    uint32_t         kh_magic;
+    _Atomic uint32_t kh_enabled;
+} ksancov_header_t;
+
+/* TRACE 모드 구조체 */
+typedef struct ksancov_trace {
+    ksancov_header_t kt_hdr;
+    uint32_t         kt_maxent;
+    _Atomic uint32_t kt_head;
+    uint64_t         kt_entries[];
+} ksancov_trace_t;
+
+/* 분석기 설정 */
+#define HP_MAX_N          8          /* n-gram 최대 길이 (윈도우 링 크기) */
+#define HP_ROWS           4          /* count-min sketch 행 수 */
+#define HP_BATCH          16         /* prefetch 묶음 크기 */
+#define HP_CHUNK_PCS      (128 * 1024)
+#define HP_ROLL_BASE      0x100000001b3ULL
+#define HP_PROGRESS_PCS   (1ULL << 28)
+
+/* count-min sketch */
+typedef struct hp_sketch {
+    uint64_t *rows[HP_ROWS];
+    uint64_t  mask;
+    uint32_t  log2w;
+} hp_sketch_t;
+
+/* top-K 항목: 힙은 항목 번호 배열, 해시 테이블은 키 -> 항목 번호 */
+typedef struct hp_entry {
+    uint64_t key;
+    uint64_t count;
+    uint32_t hpos;
+    uint64_t pcs[HP_MAX_N];
+} hp_entry_t;
+
+typedef struct hp_topk {
+    hp_entry_t *ent;
+    uint32_t   *heap;
+    uint32_t    size;
+    uint32_t    cap;
+    uint64_t   *tkeys;               /* 0 이면 빈 슬롯 */
+    uint32_t   *tvals;
+    uint64_t    tmask;
+} hp_topk_t;
+
+typedef struct hp_state {
+    uint32_t    n;
+    uint64_t    base_pow_n;          /* HP_ROLL_BASE^n */
+    uint64_t    ring[HP_MAX_N];
+    uint64_t    roll;
+    uint64_t    seen;                /* 현재 윈도우에 들어온 PC 수 */
+    uint64_t    total_pcs;
+    uint64_t    total_ngrams;
+    hp_sketch_t cms;
+    hp_topk_t   top;
+} hp_state_t;
+
+/* 심볼 맵 */
+typedef struct hp_sym {
+    uint64_t addr;
+    char    *name;
+} hp_sym_t;
+
+typedef struct hp_symtab {
+    hp_sym_t *syms;
+    size_t    count;
+    uint64_t  slide;
+} hp_symtab_t;
+
+/* 헬퍼 함수들 */
+static int ksancov_open(void) {
+    return open(KSANCOV_PATH, O_RDWR);
+}
+
+static int ksancov_map(int fd, uintptr_t *buf, size_t *sz) {
+    struct ksancov_buf_desc mc = {0};
+    int ret = ioctl(fd, KSANCOV_IOC_MAP, &mc);
+    if (ret == -1) {
+        return errno;
+    }
+    *buf = mc.ptr;
+    if (sz) {
+        *sz = mc.sz;
+    }
+    return 0;
+}
+
+static int ksancov_mode_trace(int fd, size_t entries) {
+    int ret = ioctl(fd, KSANCOV_IOC_TRACE, &entries);
+    return (ret == -1) ? errno : 0;
+}
+
+static int ksancov_thread_self(int fd) {
+    uintptr_t th = 0;
+    int ret = ioctl(fd, KSANCOV_IOC_START, &th);
+    return (ret == -1) ? errno : 0;
+}
+
+static void ksancov_start(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 1, memory_order_relaxed);
+}
+
+static void ksancov_stop(void *buf) {
+    ksancov_header_t *hdr = (ksancov_header_t *)buf;
+    atomic_store_explicit(&hdr->kh_enabled, 0, memory_order_relaxed);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t mix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x ? x : 1;
+}
+
+/* ---- count-min sketch ---- */
+
+static int cms_init(hp_sketch_t *s, uint32_t log2w) {
+    memset(s, 0, sizeof(*s));
+    s->log2w = log2w;
+    s->mask = (1ULL << log2w) - 1;
+    for (int r = 0; r < HP_ROWS; r++) {
+        s->rows[r] = calloc(1ULL << log2w, sizeof(uint64_t));
+        if (!s->rows[r]) {
+            return ENOMEM;
+        }
+    }
+    return 0;
+}
+
+static void cms_free(hp_sketch_t *s) {
+    for (int r = 0; r < HP_ROWS; r++) {
+        free(s->rows[r]);
+    }
+}
+
+/* 키 하나에서 행별 위치를 만듦 (Kirsch-Mitzenmacher) */
+static inline void cms_slots(const hp_sketch_t *s, uint64_t key, uint64_t *slot) {
+    uint64_t h1 = key & 0xffffffffULL;
+    uint64_t h2 = (key >> 32) | 1;
+    for (int r = 0; r < HP_ROWS; r++) {
+        slot[r] = (h1 + (uint64_t)r * h2) & s->mask;
+    }
+}
+
+/* conservative update: 최솟값보다 작은 카운터만 최솟값+1 로 올리고 새 추정치를 반환 */
+static inline uint64_t cms_add(hp_sketch_t *s, const uint64_t *slot) {
+    uint64_t min = UINT64_MAX;
+    for (int r = 0; r < HP_ROWS; r++) {
+        uint64_t c = s->rows[r][slot[r]];
+        min = c < min ? c : min;
+    }
+    uint64_t est = min + 1;
+    for (int r = 0; r < HP_ROWS; r++) {
+        if (s->rows[r][slot[r]] < est) {
+            s->rows[r][slot[r]] = est;
+        }
+    }
+    return est;
+}
+
+/* ---- top-K ---- */
+
+static int topk_init(hp_topk_t *t, uint32_t cap) {
+    memset(t, 0, sizeof(*t));
+    uint64_t tsize = 16;
+    while (tsize < (uint64_t)cap * 4) {
+        tsize <<= 1;
+    }
+    t->cap = cap;
+    t->tmask = tsize - 1;
+    t->ent = calloc(cap, sizeof(hp_entry_t));
+    t->heap = calloc(cap, sizeof(uint32_t));
+    t->tkeys = calloc(tsize, sizeof(uint64_t));
+    t->tvals = calloc(tsize, sizeof(uint32_t));
+    return (t->ent && t->heap && t->tkeys && t->tvals) ? 0 : ENOMEM;
+}
+
+static void topk_free(hp_topk_t *t) {
+    free(t->ent);
+    free(t->heap);
+    free(t->tkeys);
+    free(t->tvals);
+}
+
+static inline uint64_t topk_home(const hp_topk_t *t, uint64_t key) {
+    return (key ^ (key >> 29)) & t->tmask;
+}
+
+static int64_t topk_find(const hp_topk_t *t, uint64_t key) {
+    for (uint64_t s = topk_home(t, key);; s = (s + 1) & t->tmask) {
+        if (t->tkeys[s] == key) {
+            return t->tvals[s];
+        }
+        if (t->tkeys[s] == 0) {
+            return -1;
+        }
+    }
+}
+
+static void topk_table_put(hp_topk_t *t, uint64_t key, uint32_t e) {
+    uint64_t s = topk_home(t, key);
+    while (t->tkeys[s]) {
+        s = (s + 1) & t->tmask;
+    }
+    t->tkeys[s] = key;
+    t->tvals[s] = e;
+}
+
+/* linear probing 삭제 (backward shift, 톰스톤 없음) */
+static void topk_table_del(hp_topk_t *t, uint64_t key) {
+    uint64_t i = topk_home(t, key);
+    while (t->tkeys[i] != key) {
+        if (t->tkeys[i] == 0) {
+            return;
+        }
+        i = (i + 1) & t->tmask;
+    }
+    uint64_t j = i;
+    for (;;) {
+        j = (j + 1) & t->tmask;
+        if (t->tkeys[j] == 0) {
+            break;
+        }
+        uint64_t k = topk_home(t, t->tkeys[j]);
+        /* k 가 (i, j] 구간 밖이면 i 자리로 당길 수 있음 */
+        int movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            t->tkeys[i] = t->tkeys[j];
+            t->tvals[i] = t->tvals[j];
+            i = j;
+        }
+    }
+    t->tkeys[i] = 0;
+}
+
+static inline void heap_swap(hp_topk_t *t, uint32_t a, uint32_t b) {
+    uint32_t ea = t->heap[a], eb = t->heap[b];
+    t->heap[a] = eb;
+    t->heap[b] = ea;
+    t->ent[eb].hpos = a;
+    t->ent[ea].hpos = b;
+}
+
+static void heap_down(hp_topk_t *t, uint32_t i) {
+    for (;;) {
+        uint32_t l = 2 * i + 1, r = l + 1, m = i;
+        if (l < t->size && t->ent[t->heap[l]].count < t->ent[t->heap[m]].count) m = l;
+        if (r < t->size && t->ent[t->heap[r]].count < t->ent[t->heap[m]].count) m = r;
+        if (m == i) {
+            return;
+        }
+        heap_swap(t, i, m);
+        i = m;
+    }
+}
+
+static void heap_up(hp_topk_t *t, uint32_t i) {
+    while (i > 0) {
+        uint32_t p = (i - 1) / 2;
+        if (t->ent[t->heap[p]].count <= t->ent[t->heap[i]].count) {
+            return;
+        }
+        heap_swap(t, i, p);
+        i = p;
+    }
+}
+
+/* 추정치 est 를 가진 n-gram 을 top-K 에 반영 */
+static inline void topk_offer(hp_state_t *st, uint64_t key, uint64_t est) {
+    hp_topk_t *t = &st->top;
+    if (t->size == t->cap && est <= t->ent[t->heap[0]].count) {
+        return;
+    }
+
+    int64_t e = topk_find(t, key);
+    if (e >= 0) {
+        /* 이미 보관 중: 추정치는 단조 증가하므로 아래로만 내려감 */
+        t->ent[e].count = est;
+        heap_down(t, t->ent[e].hpos);
+        return;
+    }
+
+    uint32_t idx;
+    if (t->size < t->cap) {
+        idx = t->size;
+        t->heap[t->size] = idx;
+        t->ent[idx].hpos = t->size++;
+    } else {
+        idx = t->heap[0];
+        topk_table_del(t, t->ent[idx].key);
+    }
+    hp_entry_t *ne = &t->ent[idx];
+    ne->key = key;
+    ne->count = est;
+    for (uint32_t j = 0; j < st->n; j++) {
+        ne->pcs[j] = st->ring[(st->seen - st->n + j) % HP_MAX_N];
+    }
+    topk_table_put(t, key, idx);
+    heap_down(t, ne->hpos);
+    heap_up(t, ne->hpos);
+}
+
+/* ---- 스트림 처리 ---- */
+
+static int hp_init(hp_state_t *st, uint32_t n, uint32_t k, uint32_t log2w) {
+    memset(st, 0, sizeof(*st));
+    st->n = n;
+    st->base_pow_n = 1;
+    for (uint32_t i = 0; i < n; i++) {
+        st->base_pow_n *= HP_ROLL_BASE;
+    }
+    int ret = cms_init(&st->cms, log2w);
+    if (ret == 0) {
+        ret = topk_init(&st->top, k);
+    }
+    return ret;
+}
+
+static void hp_free(hp_state_t *st) {
+    cms_free(&st->cms);
+    topk_free(&st->top);
+}
+
+/* 캡처 경계: 이전 캡처의 PC 와 이어지는 n-gram 을 만들지 않음 */
+static void hp_reset_window(hp_state_t *st) {
+    st->seen = 0;
+    st->roll = 0;
+}
+
+/* PC 하나를 윈도우에 넣고 rolling hash 를 갱신. n-gram 이 완성되면 1 */
+static inline int hp_push(hp_state_t *st, uint64_t pc) {
+    uint64_t out = st->seen >= st->n ? st->ring[(st->seen - st->n) % HP_MAX_N] : 0;
+    st->roll = st->roll * HP_ROLL_BASE + pc - out * st->base_pow_n;
+    st->ring[st->seen % HP_MAX_N] = pc;
+    st->seen++;
+    return st->seen >= st->n;
+}
+
+/*
+ * PC 배열 처리. sketch 갱신은 n-gram 마다 4번의 임의 접근이므로 HP_BATCH 개씩
+ * 키와 위치를 먼저 계산해 prefetch 한 뒤 갱신합니다. top-K 에 넣을 때 윈도우 링이
+ * 필요하므로 갱신 단계에서 PC 를 다시 밀어 넣습니다 (rolling hash 는 결정적).
+ */
+static void hp_process(hp_state_t *st, const uint64_t *pcs, size_t count) {
+    uint64_t slot[HP_BATCH][HP_ROWS];
+    uint64_t key[HP_BATCH];
+    int valid[HP_BATCH];
+
+    for (size_t i = 0; i < count; i += HP_BATCH) {
+        size_t nb = count - i < HP_BATCH ? count - i : HP_BATCH;
+
+        /* 1단계: 윈도우 사본으로 키 계산 + prefetch */
+        uint64_t roll = st->roll, seen = st->seen;
+        uint64_t ring[HP_MAX_N];
+        memcpy(ring, st->ring, sizeof(ring));
+        for (size_t b = 0; b < nb; b++) {
+            uint64_t pc = pcs[i + b];
+            uint64_t out = seen >= st->n ? ring[(seen - st->n) % HP_MAX_N] : 0;
+            roll = roll * HP_ROLL_BASE + pc - out * st->base_pow_n;
+            ring[seen % HP_MAX_N] = pc;
+            seen++;
+            valid[b] = seen >= st->n;
+            if (valid[b]) {
+                key[b] = mix64(roll);
+                cms_slots(&st->cms, key[b], slot[b]);
+                for (int r = 0; r < HP_ROWS; r++) {
+                    __builtin_prefetch(&st->cms.rows[r][slot[b][r]], 1);
+                }
+            }
+        }
+
+        /* 2단계: sketch 갱신 + top-K */
+        for (size_t b = 0; b < nb; b++) {
+            hp_push(st, pcs[i + b]);
+            if (valid[b]) {
+                uint64_t est = cms_add(&st->cms, slot[b]);
+                st->total_ngrams++;
+                topk_offer(st, key[b], est);
+            }
+        }
+        st->total_pcs += nb;
+    }
+}
+
+/* ---- 심볼 맵 ---- */
+
+static int sym_cmp(const void *a, const void *b) {
+    const hp_sym_t *x = a, *y = b;
+    return (x->addr > y->addr) - (x->addr < y->addr);
+}
+
+/* "주소 [타입] 심볼" 형식의 줄들을 읽음 (nm 출력 호환). 마지막 토큰을 심볼로 사용 */
+static int symtab_load(hp_symtab_t *tab, const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return errno;
+    }
+    size_t cap = 4096;
+    tab->syms = malloc(cap * sizeof(hp_sym_t));
+    tab->count = 0;
+    char line[1024];
+    while (tab->syms && fgets(line, sizeof(line), f)) {
+        char *end;
+        uint64_t addr = strtoull(line, &end, 16);
+        if (end == line) {
+            continue;
+        }
+        char *name = NULL;
+        for (char *tok = strtok(end, " \t\r\n"); tok; tok = strtok(NULL, " \t\r\n")) {
+            name = tok;
+        }
+        if (!name) {
+            continue;
+        }
+        if (tab->count == cap) {
+            cap *= 2;
+            hp_sym_t *grown = realloc(tab->syms, cap * sizeof(hp_sym_t));
+            if (!grown) {
+                break;
+            }
+            tab->syms = grown;
+        }
+        tab->syms[tab->count].addr = addr;
+        tab->syms[tab->count].name = strdup(name);
+        tab->count++;
+    }
+    fclose(f);
+    if (!tab->syms) {
+        return ENOMEM;
+    }
+    qsort(tab->syms, tab->count, sizeof(hp_sym_t), sym_cmp);
+    return 0;
+}
+
+static void symtab_free(hp_symtab_t *tab) {
+    for (size_t i = 0; i < tab->count; i++) {
+        free(tab->syms[i].name);
+    }
+    free(tab->syms);
+}
+
+/* pc 이하의 가장 큰 주소를 가진 심볼 (없으면 NULL) */
+static const hp_sym_t *symtab_lookup(const hp_symtab_t *tab, uint64_t pc, uint64_t *off) {
+    if (!tab || tab->count == 0) {
+        return NULL;
+    }
+    uint64_t a = pc - tab->slide;
+    size_t lo = 0, hi = tab->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (tab->syms[mid].addr <= a) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == 0) {
+        return NULL;
+    }
+    *off = a - tab->syms[lo - 1].addr;
+    return &tab->syms[lo - 1];
+}
+
+/* ---- 결과 출력 ---- */
+
+static int entry_cmp_desc(const void *a, const void *b) {
+    const hp_entry_t *x = a, *y = b;
+    return (x->count < y->count) - (x->count > y->count);
+}
+
+static void hp_report(const hp_state_t *st, const hp_symtab_t *tab, double sec) {
+    const hp_topk_t *t = &st->top;
+    hp_entry_t *sorted = malloc((t->size ? t->size : 1) * sizeof(hp_entry_t));
+    if (!sorted) {
+        return;
+    }
+    memcpy(sorted, t->ent, t->size * sizeof(hp_entry_t));
+    qsort(sorted, t->size, sizeof(hp_entry_t), entry_cmp_desc);
+
+    double width = (double)(1ULL << st->cms.log2w);
+    printf("\n=== 핫 패스 분석 결과 ===\n");
+    printf("PC %llu개, %u-gram %llu개, %.2f초 (%.1f M PCs/s)\n",
+           (unsigned long long)st->total_pcs, st->n, (unsigned long long)st->total_ngrams,
+           sec, sec > 0 ? st->total_pcs / sec / 1e6 : 0.0);
+    printf("sketch: %d x %.0f (%.1f MB), 추정 오차 한계 ≈ +%.0f (e/w * 전체)\n",
+           HP_ROWS, width, HP_ROWS * width * sizeof(uint64_t) / (1024.0 * 1024.0),
+           2.718281828 / width * (double)st->total_ngrams);
+
+    for (uint32_t i = 0; i < t->size; i++) {
+        const hp_entry_t *e = &sorted[i];
+        printf("\n#%-3u 추정 %llu회 (%.2f%%)\n", i + 1, (unsigned long long)e->count,
+               st->total_ngrams ? 100.0 * e->count / st->total_ngrams : 0.0);
+        for (uint32_t j = 0; j < st->n; j++) {
+            uint64_t off = 0;
+            const hp_sym_t *sym = symtab_lookup(tab, e->pcs[j], &off);
+            if (sym) {
+                printf("     0x%016llx  %s+0x%llx\n", (unsigned long long)e->pcs[j],
+                       sym->name, (unsigned long long)off);
+            } else {
+                printf("     0x%016llx\n", (unsigned long long)e->pcs[j]);
+            }
+        }
+    }
+    free(sorted);
+}
+
+/* ---- 입력 ---- */
+
+static int run_file(hp_state_t *st, const char *path) {
+    int fd = strcmp(path, "-") == 0 ? STDIN_FILENO : open(path, O_RDONLY);
+    if (fd < 0) {
+        return errno;
+    }
+    uint64_t *buf = malloc(HP_CHUNK_PCS * sizeof(uint64_t));
+    if (!buf) {
+        if (fd != STDIN_FILENO) close(fd);
+        return ENOMEM;
+    }
+
+    /* 파이프 입력은 8바이트 경계가 아닌 곳에서 끊길 수 있으므로 나머지를 이어 붙임 */
+    size_t have = 0;
+    uint64_t next_report = HP_PROGRESS_PCS;
+    int ret = 0;
+    for (;;) {
+        ssize_t r = read(fd, (uint8_t *)buf + have, HP_CHUNK_PCS * sizeof(uint64_t) - have);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            ret = errno;
+            break;
+        }
+        if (r == 0) {
+            break;
+        }
+        have += (size_t)r;
+        size_t npcs = have / sizeof(uint64_t);
+        hp_process(st, buf, npcs);
+        size_t rest = have - npcs * sizeof(uint64_t);
+        memmove(buf, (uint8_t *)buf + npcs * sizeof(uint64_t), rest);
+        have = rest;
+
+        if (st->total_pcs >= next_report) {
+            fprintf(stderr, "  ... PC %llu개 처리\n", (unsigned long long)st->total_pcs);
+            next_report += HP_PROGRESS_PCS;
+        }
+    }
+    if (have) {
+        printf("경고: 끝의 %zu 바이트는 PC 크기(8)에 맞지 않아 무시\n", have);
+    }
+    free(buf);
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
+    return ret;
+}
+
+/* 측정용 워크로드 (perform_test_operations 와 같은 종류, 출력 없음) */
+static void hotpath_workload(void) {
+    int fd = open("/tmp/kcov_hotpath.txt", O_CREAT | O_WRONLY | O_TRUNC, 0644);
+    if (fd >= 0) {
+        (void)!write(fd, "Hello, kernel coverage!\n", 24);
+        fsync(fd);
+        close(fd);
+        unlink("/tmp/kcov_hotpath.txt");
+    }
+    (void)getpid();
+    (void)getppid();
+    void *mem = malloc(4096);
+    if (mem) {
+        memset(mem, 0x42, 4096);
+        free(mem);
+    }
+    (void)time(NULL);
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock >= 0) {
+        close(sock);
+    }
+}
+
+static int run_live(hp_state_t *st, uint32_t iterations, size_t max_entries) {
+    int fd = ksancov_open();
+    if (fd < 0) {
+        perror("ksancov_open");
+        return errno;
+    }
+    int ret = ksancov_mode_trace(fd, max_entries);
+    if (ret != 0) {
+        printf("TRACE 모드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    uintptr_t buf = 0;
+    size_t sz = 0;
+    ret = ksancov_map(fd, &buf, &sz);
+    if (ret != 0) {
+        printf("버퍼 매핑 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+    ret = ksancov_thread_self(fd);
+    if (ret != 0) {
+        printf("스레드 설정 실패: %s\n", strerror(ret));
+        close(fd);
+        return ret;
+    }
+
+    ksancov_trace_t *trace = (ksancov_trace_t *)buf;
+    uint32_t overflows = 0;
+    for (uint32_t it = 0; it < iterations; it++) {
+        atomic_store_explicit(&trace->kt_head, 0, memory_order_relaxed);
+        ksancov_start(trace);
+        hotpath_workload();
+        ksancov_stop(trace);
+
+        uint32_t head = atomic_load_explicit(&trace->kt_head, memory_order_acquire);
+        if (head >= trace->kt_maxent) {
+            head = trace->kt_maxent;
+            overflows++;
+        }
+        hp_reset_window(st);
+        hp_process(st, trace->kt_entries, head);
+    }
+    if (overflows) {
+        printf("경고: %u회 캡처에서 TRACE 버퍼가 가득 찼습니다 (최대 %u 엔트리)\n",
+               overflows, trace->kt_maxent);
+    }
+    close(fd);
+    return 0;
+}
+
+static void usage(const char *prog) {
+    printf("사용법:\n");
+    printf("  %s file <trace.bin | -> [옵션]\n", prog);
+    printf("  %s live [반복수] [옵션]\n", prog);
+    printf("옵션:\n");
+    printf("  -n N        n-gram 길이 (1-%d, 기본 4)\n", HP_MAX_N);
+    printf("  -k K        출력할 상위 경로 수 (기본 20)\n");
+    printf("  -w LOG2     sketch 행 너비 log2 (10-26, 기본 20)\n");
+    printf("  -e N        live 모드 TRACE 버퍼 엔트리 수 (기본 262144)\n");
+    printf("  -s 파일     주소 맵 (\"주소 [타입] 심볼\", nm 출력)\n");
+    printf("  --slide X   PC 에서 뺄 커널 슬라이드 (16진수)\n");
+}
+
+/* 메인 함수 */
+int main(int argc, char *argv[]) {
+    uint32_t n = 4, k = 20, log2w = 20, iterations = 100;
+    size_t max_entries = 256 * 1024;
+    const char *sym_path = NULL;
+    const char *input = NULL;
+    uint64_t slide = 0;
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+    const char *cmd = argv[1];
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            n = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            k = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            log2w = (uint32_t)strtoul(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc) {
+            max_entries = strtoull(argv[++i], NULL, 0);
+        } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            sym_path = argv[++i];
+        } else if (strcmp(argv[i], "--slide") == 0 && i + 1 < argc) {
+            slide = strtoull(argv[++i], NULL, 16);
+        } else if (!input) {
+            input = argv[i];
+        }
+    }
+    if (n < 1 || n > HP_MAX_N || k < 1 || log2w < 10 || log2w > 26) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    hp_symtab_t tab = { NULL, 0, slide };
+    if (sym_path) {
+        int ret = symtab_load(&tab, sym_path);
+        if (ret != 0) {
+            printf("주소 맵 로드 실패 (%s): %s\n", sym_path, strerror(ret));
+            return ret;
+        }
+        printf("주소 맵: 심볼 %zu개\n", tab.count);
+    }
+
+    hp_state_t st;
+    int ret = hp_init(&st, n, k, log2w);
+    if (ret != 0) {
+        printf("초기화 실패: %s\n", strerror(ret));
+        return ret;
+    }
+
+    uint64_t t0 = now_ns();
+    if (strcmp(cmd, "file") == 0 && input) {
+        ret = run_file(&st, input);
+    } else if (strcmp(cmd, "live") == 0) {
+        if (input) {
+            iterations = (uint32_t)strtoul(input, NULL, 0);
+        }
+        ret = run_live(&st, iterations, max_entries);
+    } else {
+        usage(argv[0]);
+        ret = 1;
+    }
+    double sec = (double)(now_ns() - t0) / 1e9;
+
+    if (ret == 0) {
+        hp_report(&st, sym_path ? &tab : NULL, sec);
+    } else if (ret != 1) {
+        printf("%s 실패: %s\n", cmd, strerror(ret));
+    }
+
+    hp_free(&st);
+    symtab_free(&tab);
+    return ret;
+}